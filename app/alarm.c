@@ -0,0 +1,897 @@
+//*****************************************************************************
+//
+// alarm.c - threshold alarms on MIB objects, modelled on the RMON alarm group
+//
+// Each alarm row samples one integer object of the agent's own MIB tree,
+// either its absolute value or its change since the previous sample, and
+// sends an enterprise specific trap when the sample crosses the rising or
+// falling threshold.  As in RMON, after a rising alarm no other rising alarm
+// is sent until the falling threshold has been crossed, and vice versa.
+//
+//*****************************************************************************
+#include <string.h>
+#include "hw_types.h"
+#include "interrupt.h"
+#include "uartstdio.h"
+#include "../lwip-1.3.0/src/include/lwip/opt.h"
+#include "../lwip-1.3.0/src/include/lwip/snmp.h"
+#include "../lwip-1.3.0/src/include/lwip/snmp_asn1.h"
+#include "../lwip-1.3.0/src/include/lwip/snmp_structs.h"
+#include "../lwip-1.3.0/src/include/lwip/snmp_msg.h"
+#include "../lwip-1.3.0/src/include/lwip/netif.h"
+#include "../lwip-1.3.0/src/include/ipv4/lwip/inet.h"
+#include "../lwip-1.3.0/src/include/netif/etharp.h"
+#include "softeeprom_wrapper.h"
+#include "storage_config.h"
+#include "alarm.h"
+
+//*****************************************************************************
+//
+// The room for the variable OID in the stored configuration.  The OID is
+// stored without its 1.3.6.1 prefix, each sub-identifier encoded in base 128
+// as in BER, which fits the BACON objects with room to spare.
+//
+//*****************************************************************************
+#define ALARM_OID_BYTES         20
+
+//*****************************************************************************
+//
+// Configuration flags.
+//
+//*****************************************************************************
+#define ALARM_FLAG_DELTA        0x01
+#define ALARM_FLAG_RISING       0x02        // startup alarm includes rising
+#define ALARM_FLAG_FALLING      0x04        // startup alarm includes falling
+#define ALARM_FLAG_VALID        0x08
+
+//*****************************************************************************
+//
+// The times a trap that could not be queued for sending is tried again, once
+// a second, before it is given up.
+//
+//*****************************************************************************
+#define ALARM_TRAP_RETRIES      3
+
+//*****************************************************************************
+//
+// The configuration of an alarm row, stored as is in the soft EEPROM at
+// EEPROM_ALARM_ADDR, ALARM_CONFIG_SIZE bytes apart.
+//
+//*****************************************************************************
+typedef struct
+{
+    unsigned short usInterval;
+    unsigned char ucFlags;
+    unsigned char ucOidBytes;
+    long lRising;
+    long lFalling;
+    unsigned char pucOid[ALARM_OID_BYTES];
+}
+tAlarmConfig;
+
+#define ALARM_CONFIG_SIZE       32
+
+//*****************************************************************************
+//
+// An alarm row: its configuration, the decoded variable and the sampling
+// state.  ucArmed holds the ALARM_FLAG_RISING and ALARM_FLAG_FALLING bits of
+// the alarms that may be sent next.  ucTrapPending is the ALARM_TRAP_* trap
+// waiting to be sent again, if any.
+//
+//*****************************************************************************
+typedef struct
+{
+    tAlarmConfig sConfig;
+    s32_t plOid[ALARM_OID_LEN];
+    unsigned char ucOidLen;
+    unsigned char ucArmed;
+    unsigned char bPrimed;
+    unsigned char ucTrapPending;
+    unsigned char ucTrapRetries;
+    unsigned short usCountdown;
+    unsigned long ulPrevious;
+    long lValue;
+}
+tAlarm;
+
+static tAlarm g_psAlarms[ALARM_NUM_ROWS];
+
+//*****************************************************************************
+//
+// The trap destination, in host order, or 0 if traps are not sent.
+//
+//*****************************************************************************
+static unsigned long g_ulAlarmTrapDest;
+
+//*****************************************************************************
+//
+// Counters.
+//
+//*****************************************************************************
+static unsigned long g_ulAlarmSamples;
+static unsigned long g_ulAlarmSampleErrors;
+static unsigned long g_ulAlarmTraps;
+static unsigned long g_ulAlarmTrapRetries;
+static unsigned long g_ulAlarmTrapsLost;
+
+//*****************************************************************************
+//
+// The enterprise OID of the traps, 1.3.6.1.4.1.34509.200.161, and the base
+// of the alarm table columns, 1.3.6.1.4.1.34509.200.161.6.1.
+//
+//*****************************************************************************
+static struct snmp_obj_id g_sAlarmEnterprise =
+{
+    9, { 1, 3, 6, 1, 4, 1, 34509, 200, 161 }
+};
+
+#define ALARM_TABLE_OID_LEN     11
+static const s32_t g_plAlarmTableOid[ALARM_TABLE_OID_LEN] =
+{
+    1, 3, 6, 1, 4, 1, 34509, 200, 161, 6, 1
+};
+
+//*****************************************************************************
+//
+// Decode the stored variable OID of an alarm row.  A row whose OID does not
+// decode is made invalid.
+//
+//*****************************************************************************
+static void
+AlarmOidDecode(tAlarm *psAlarm)
+{
+    const unsigned char *pucByte;
+    unsigned long ulBytes, ulSubId;
+
+    psAlarm->ucOidLen = 0;
+    pucByte = psAlarm->sConfig.pucOid;
+    ulBytes = psAlarm->sConfig.ucOidBytes;
+    if(ulBytes > ALARM_OID_BYTES)
+    {
+        psAlarm->sConfig.ucFlags &= ~ALARM_FLAG_VALID;
+        return;
+    }
+
+    ulSubId = 0;
+    while(ulBytes--)
+    {
+        ulSubId = (ulSubId << 7) | (*pucByte & 0x7f);
+        if(!(*pucByte++ & 0x80))
+        {
+            if(psAlarm->ucOidLen == (ALARM_OID_LEN - 4))
+            {
+                psAlarm->ucOidLen = 0;
+                break;
+            }
+            psAlarm->plOid[psAlarm->ucOidLen++] = ulSubId;
+            ulSubId = 0;
+        }
+    }
+
+    if(psAlarm->ucOidLen == 0)
+    {
+        psAlarm->sConfig.ucFlags &= ~ALARM_FLAG_VALID;
+    }
+}
+
+//*****************************************************************************
+//
+// Encode a variable OID, without its 1.3.6.1 prefix, into pucOid.  Returns
+// the number of bytes used, or 0 if it does not fit.
+//
+//*****************************************************************************
+static unsigned long
+AlarmOidEncode(const long *plOid, unsigned long ulLen, unsigned char *pucOid)
+{
+    unsigned long ulBytes, ulSubId;
+    int iShift;
+
+    ulBytes = 0;
+    while(ulLen--)
+    {
+        ulSubId = (unsigned long)*plOid++;
+        for(iShift = 28; (iShift > 0) && !(ulSubId >> iShift); iShift -= 7)
+        {
+        }
+        for(; iShift >= 0; iShift -= 7)
+        {
+            if(ulBytes == ALARM_OID_BYTES)
+            {
+                return(0);
+            }
+            pucOid[ulBytes++] = ((ulSubId >> iShift) & 0x7f) |
+                                (iShift ? 0x80 : 0);
+        }
+    }
+
+    return(ulBytes);
+}
+
+//*****************************************************************************
+//
+// Restart the sampling of an alarm row after its configuration changed.
+//
+//*****************************************************************************
+static void
+AlarmRestart(tAlarm *psAlarm)
+{
+    psAlarm->ucArmed = psAlarm->sConfig.ucFlags &
+                       (ALARM_FLAG_RISING | ALARM_FLAG_FALLING);
+    psAlarm->bPrimed = 0;
+    psAlarm->ucTrapPending = 0;
+    psAlarm->usCountdown = psAlarm->sConfig.usInterval;
+    psAlarm->lValue = 0;
+}
+
+//*****************************************************************************
+//
+// Store the configuration of alarm row ulIndex, which was psOld before the
+// change, and restart it.  The soft EEPROM keeps 16-bit words, so only the
+// runs of words that differ from psOld are written; a Set of one column then
+// costs one or two words rather than the whole row.
+//
+//*****************************************************************************
+static void
+AlarmSave(unsigned long ulIndex, const tAlarmConfig *psOld)
+{
+    const unsigned short *pusOld, *pusNew;
+    tAlarm *psAlarm;
+    unsigned long ulWord, ulStart;
+
+    psAlarm = &g_psAlarms[ulIndex - 1];
+    pusOld = (const unsigned short *)psOld;
+    pusNew = (const unsigned short *)&psAlarm->sConfig;
+    for(ulWord = 0; ulWord < (sizeof(tAlarmConfig) / 2); ulWord++)
+    {
+        if(pusOld[ulWord] == pusNew[ulWord])
+        {
+            continue;
+        }
+        for(ulStart = ulWord; ulWord < (sizeof(tAlarmConfig) / 2); ulWord++)
+        {
+            if(pusOld[ulWord] == pusNew[ulWord])
+            {
+                break;
+            }
+        }
+        SoftEEPROM_WrapperWrite(EEPROM_ALARM_ADDR +
+                                ((ulIndex - 1) * ALARM_CONFIG_SIZE) +
+                                (ulStart * 2), (ulWord - ulStart) * 2,
+                                (const unsigned char *)(pusNew + ulStart));
+    }
+    AlarmRestart(psAlarm);
+}
+
+//*****************************************************************************
+//
+// Load the alarm rows and the trap destination from the soft EEPROM.  Must
+// be called after the soft EEPROM and lwIP have been initialized.
+//
+//*****************************************************************************
+void
+AlarmInit(void)
+{
+    tAlarm *psAlarm;
+    unsigned long ulIPAddr;
+    int i;
+
+    psAlarm = g_psAlarms;
+    for(i = 0; i < ALARM_NUM_ROWS; i++, psAlarm++)
+    {
+        SoftEEPROM_WrapperRead(EEPROM_ALARM_ADDR + (i * ALARM_CONFIG_SIZE),
+                               sizeof(tAlarmConfig),
+                               (unsigned char *)&psAlarm->sConfig);
+
+        //
+        // An unprogrammed row reads as all ones.
+        //
+        if(psAlarm->sConfig.ucOidBytes == 0xFF)
+        {
+            psAlarm->sConfig.usInterval = 10;
+            psAlarm->sConfig.ucFlags = ALARM_FLAG_RISING | ALARM_FLAG_FALLING;
+            psAlarm->sConfig.ucOidBytes = 0;
+            psAlarm->sConfig.lRising = 1;
+            psAlarm->sConfig.lFalling = 0;
+        }
+
+        AlarmOidDecode(psAlarm);
+        AlarmRestart(psAlarm);
+    }
+
+    SoftEEPROM_WrapperRead(EEPROM_TRAP_ADDR, sizeof(unsigned long),
+                           (unsigned char *)&ulIPAddr);
+    if(ulIPAddr != 0xFFFFFFFF)
+    {
+        g_ulAlarmTrapDest = ulIPAddr;
+        if(ulIPAddr)
+        {
+            struct ip_addr sAddr;
+
+            sAddr.addr = htonl(ulIPAddr);
+            snmp_trap_dst_ip_set(0, &sAddr);
+            snmp_trap_dst_enable(0, 1);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Set the trap destination, in host order, and store it.  0 stops sending
+// traps.  Called from the console, so lwIP is kept out while it is changed.
+//
+//*****************************************************************************
+void
+AlarmTrapDestSet(unsigned long ulIPAddr)
+{
+    struct ip_addr sAddr;
+    tBoolean bIntsOff;
+
+    SoftEEPROM_WrapperWrite(EEPROM_TRAP_ADDR, sizeof(unsigned long),
+                            (unsigned char *)&ulIPAddr);
+
+    bIntsOff = IntMasterDisable();
+    g_ulAlarmTrapDest = ulIPAddr;
+    sAddr.addr = htonl(ulIPAddr);
+    snmp_trap_dst_ip_set(0, &sAddr);
+    snmp_trap_dst_enable(0, ulIPAddr ? 1 : 0);
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+}
+
+//*****************************************************************************
+//
+// Return the trap destination, in host order.
+//
+//*****************************************************************************
+unsigned long
+AlarmTrapDestGet(void)
+{
+    return(g_ulAlarmTrapDest);
+}
+
+//*****************************************************************************
+//
+// Read the variable of an alarm row through the MIB tree, exactly as a Get
+// request would.  Returns 0 if it does not name an integer object.
+//
+//*****************************************************************************
+static int
+AlarmSample(tAlarm *psAlarm, unsigned long *pulValue)
+{
+    struct snmp_name_ptr sName;
+    struct mib_node *psNode;
+    struct obj_def sDef;
+
+    psNode = snmp_search_tree((struct mib_node *)&internet, psAlarm->ucOidLen,
+                              psAlarm->plOid, &sName);
+    if((psNode == NULL) || (psNode->node_type == MIB_NODE_EX))
+    {
+        return(0);
+    }
+
+    psNode->get_object_def(sName.ident_len, sName.ident, &sDef);
+    if((sDef.instance == MIB_OBJECT_NONE) ||
+       (sDef.access == MIB_OBJECT_WRITE_ONLY) ||
+       (sDef.access == MIB_OBJECT_NOT_ACCESSIBLE) ||
+       (sDef.v_len != sizeof(u32_t)))
+    {
+        return(0);
+    }
+
+    switch(sDef.asn_type)
+    {
+        case (SNMP_ASN1_UNIV | SNMP_ASN1_PRIMIT | SNMP_ASN1_INTEG):
+        case (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_COUNTER):
+        case (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_GAUGE):
+        case (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_TIMETICKS):
+        {
+            break;
+        }
+        default:
+        {
+            return(0);
+        }
+    }
+
+    psNode->get_value(&sDef, sizeof(u32_t), pulValue);
+    return(1);
+}
+
+//*****************************************************************************
+//
+// Add a varbind for column ulParam of alarm row ulIndex to the trap.
+//
+//*****************************************************************************
+static void
+AlarmTrapVarbind(unsigned long ulIndex, unsigned long ulParam, u8_t ucType,
+                 const void *pvValue, u8_t ucLen)
+{
+    struct snmp_obj_id sOid;
+    struct snmp_varbind *psVb;
+    int i;
+
+    for(i = 0; i < ALARM_TABLE_OID_LEN; i++)
+    {
+        sOid.id[i] = g_plAlarmTableOid[i];
+    }
+    sOid.id[i++] = ulParam;
+    sOid.id[i++] = ulIndex;
+    sOid.len = i;
+
+    psVb = snmp_varbind_alloc(&sOid, ucType, ucLen);
+    if(psVb != NULL)
+    {
+        MEMCPY(psVb->value, pvValue, ucLen);
+        snmp_varbind_tail_add(&trap_msg.outvb, psVb);
+    }
+}
+
+//*****************************************************************************
+//
+// Send a rising or falling alarm trap for alarm row ulIndex, carrying the
+// variable and the sample that crossed the threshold.  Returns ERR_MEM if
+// the trap could not be built or queued for sending.
+//
+//*****************************************************************************
+static err_t
+AlarmTrapSend(unsigned long ulIndex, tAlarm *psAlarm, s32_t lSpecific)
+{
+    long plOid[ALARM_OID_LEN];
+    unsigned long ulLen;
+    err_t eErr;
+
+    trap_msg.outvb.head = NULL;
+    trap_msg.outvb.tail = NULL;
+    trap_msg.outvb.count = 0;
+
+    ulLen = AlarmVariableGet(ulIndex, plOid);
+    AlarmTrapVarbind(ulIndex, ALARM_VARIABLE,
+                     (SNMP_ASN1_UNIV | SNMP_ASN1_PRIMIT | SNMP_ASN1_OBJ_ID),
+                     plOid, ulLen * sizeof(s32_t));
+    AlarmTrapVarbind(ulIndex, ALARM_VALUE,
+                     (SNMP_ASN1_UNIV | SNMP_ASN1_PRIMIT | SNMP_ASN1_INTEG),
+                     &psAlarm->lValue, sizeof(s32_t));
+
+    eErr = snmp_send_trap(SNMP_GENTRAP_ENTERPRISESPC, &g_sAlarmEnterprise,
+                          lSpecific);
+    snmp_varbind_list_free(&trap_msg.outvb);
+
+    return(eErr);
+}
+
+//*****************************************************************************
+//
+// Send the trap for an alarm of row ulIndex, or keep it to be sent again if
+// the buffers or the Ethernet transmit queue are full.
+//
+//*****************************************************************************
+static void
+AlarmTrap(unsigned long ulIndex, tAlarm *psAlarm, s32_t lSpecific)
+{
+    g_ulAlarmTraps++;
+    psAlarm->ucTrapPending = 0;
+    if(g_ulAlarmTrapDest == 0)
+    {
+        return;
+    }
+
+    if(AlarmTrapSend(ulIndex, psAlarm, lSpecific) == ERR_MEM)
+    {
+        psAlarm->ucTrapPending = (unsigned char)lSpecific;
+        psAlarm->ucTrapRetries = ALARM_TRAP_RETRIES;
+    }
+}
+
+//*****************************************************************************
+//
+// Try again to send the pending trap of row ulIndex.
+//
+//*****************************************************************************
+static void
+AlarmTrapRetry(unsigned long ulIndex, tAlarm *psAlarm)
+{
+    g_ulAlarmTrapRetries++;
+    if((g_ulAlarmTrapDest == 0) ||
+       (AlarmTrapSend(ulIndex, psAlarm, psAlarm->ucTrapPending) != ERR_MEM))
+    {
+        psAlarm->ucTrapPending = 0;
+    }
+    else if(--psAlarm->ucTrapRetries == 0)
+    {
+        psAlarm->ucTrapPending = 0;
+        g_ulAlarmTrapsLost++;
+    }
+}
+
+//*****************************************************************************
+//
+// Sample the alarm rows that are due.  Called once a second from
+// lwIPServiceTimers().
+//
+//*****************************************************************************
+void
+AlarmTimerHandler(void)
+{
+    tAlarm *psAlarm;
+    unsigned long ulIndex, ulSample;
+    long lValue;
+
+    psAlarm = g_psAlarms;
+    for(ulIndex = 1; ulIndex <= ALARM_NUM_ROWS; ulIndex++, psAlarm++)
+    {
+        if(!(psAlarm->sConfig.ucFlags & ALARM_FLAG_VALID))
+        {
+            continue;
+        }
+
+        //
+        // A pending trap goes before the next sample, which may change the
+        // value it carries.
+        //
+        if(psAlarm->ucTrapPending)
+        {
+            AlarmTrapRetry(ulIndex, psAlarm);
+        }
+
+        if(--psAlarm->usCountdown != 0)
+        {
+            continue;
+        }
+        psAlarm->usCountdown = psAlarm->sConfig.usInterval;
+
+        if(!AlarmSample(psAlarm, &ulSample))
+        {
+            g_ulAlarmSampleErrors++;
+            continue;
+        }
+        g_ulAlarmSamples++;
+
+        if(psAlarm->sConfig.ucFlags & ALARM_FLAG_DELTA)
+        {
+            lValue = (long)(ulSample - psAlarm->ulPrevious);
+            psAlarm->ulPrevious = ulSample;
+            if(!psAlarm->bPrimed)
+            {
+                psAlarm->bPrimed = 1;
+                continue;
+            }
+        }
+        else
+        {
+            lValue = (long)ulSample;
+        }
+        psAlarm->lValue = lValue;
+
+        if((psAlarm->ucArmed & ALARM_FLAG_RISING) &&
+           (lValue >= psAlarm->sConfig.lRising))
+        {
+            psAlarm->ucArmed = ALARM_FLAG_FALLING;
+            AlarmTrap(ulIndex, psAlarm, ALARM_TRAP_RISING);
+        }
+        else if((psAlarm->ucArmed & ALARM_FLAG_FALLING) &&
+                (lValue <= psAlarm->sConfig.lFalling))
+        {
+            psAlarm->ucArmed = ALARM_FLAG_RISING;
+            AlarmTrap(ulIndex, psAlarm, ALARM_TRAP_FALLING);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Return parameter ulParam of alarm row ulIndex.  ALARM_VARIABLE is read with
+// AlarmVariableGet() instead.
+//
+//*****************************************************************************
+long
+AlarmParamGet(unsigned long ulIndex, unsigned long ulParam)
+{
+    tAlarm *psAlarm;
+
+    if((ulIndex == 0) || (ulIndex > ALARM_NUM_ROWS))
+    {
+        return(0);
+    }
+    psAlarm = &g_psAlarms[ulIndex - 1];
+
+    switch(ulParam)
+    {
+        case ALARM_INDEX:
+        {
+            return(ulIndex);
+        }
+        case ALARM_INTERVAL:
+        {
+            return(psAlarm->sConfig.usInterval);
+        }
+        case ALARM_SAMPLE_TYPE:
+        {
+            return((psAlarm->sConfig.ucFlags & ALARM_FLAG_DELTA) ?
+                   ALARM_DELTA : ALARM_ABSOLUTE);
+        }
+        case ALARM_VALUE:
+        {
+            return(psAlarm->lValue);
+        }
+        case ALARM_STARTUP:
+        {
+            return((psAlarm->sConfig.ucFlags &
+                    (ALARM_FLAG_RISING | ALARM_FLAG_FALLING)) >> 1);
+        }
+        case ALARM_RISING:
+        {
+            return(psAlarm->sConfig.lRising);
+        }
+        case ALARM_FALLING:
+        {
+            return(psAlarm->sConfig.lFalling);
+        }
+        case ALARM_STATUS:
+        {
+            return((psAlarm->sConfig.ucFlags & ALARM_FLAG_VALID) ?
+                   ALARM_STATUS_VALID : ALARM_STATUS_INVALID);
+        }
+        default:
+        {
+            return(0);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Check a new value for parameter ulParam of alarm row ulIndex.  A row can
+// only be made valid once it has a variable.
+//
+//*****************************************************************************
+int
+AlarmParamValid(unsigned long ulIndex, unsigned long ulParam, long lValue)
+{
+    if((ulIndex == 0) || (ulIndex > ALARM_NUM_ROWS))
+    {
+        return(0);
+    }
+
+    switch(ulParam)
+    {
+        case ALARM_INTERVAL:
+        {
+            return((lValue > 0) && (lValue <= 0xFFFF));
+        }
+        case ALARM_SAMPLE_TYPE:
+        {
+            return((lValue == ALARM_ABSOLUTE) || (lValue == ALARM_DELTA));
+        }
+        case ALARM_STARTUP:
+        {
+            return((lValue >= ALARM_STARTUP_RISING) &&
+                   (lValue <= ALARM_STARTUP_BOTH));
+        }
+        case ALARM_RISING:
+        case ALARM_FALLING:
+        {
+            return(1);
+        }
+        case ALARM_STATUS:
+        {
+            return((lValue == ALARM_STATUS_INVALID) ||
+                   ((lValue == ALARM_STATUS_VALID) &&
+                    (g_psAlarms[ulIndex - 1].ucOidLen != 0)));
+        }
+        default:
+        {
+            return(0);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Change parameter ulParam of alarm row ulIndex, which has been checked with
+// AlarmParamValid(), and store the row.
+//
+//*****************************************************************************
+void
+AlarmParamSet(unsigned long ulIndex, unsigned long ulParam, long lValue)
+{
+    tAlarmConfig *psConfig, sOld;
+
+    if((ulIndex == 0) || (ulIndex > ALARM_NUM_ROWS))
+    {
+        return;
+    }
+    psConfig = &g_psAlarms[ulIndex - 1].sConfig;
+    sOld = *psConfig;
+
+    switch(ulParam)
+    {
+        case ALARM_INTERVAL:
+        {
+            psConfig->usInterval = (unsigned short)lValue;
+            break;
+        }
+        case ALARM_SAMPLE_TYPE:
+        {
+            psConfig->ucFlags &= ~ALARM_FLAG_DELTA;
+            if(lValue == ALARM_DELTA)
+            {
+                psConfig->ucFlags |= ALARM_FLAG_DELTA;
+            }
+            break;
+        }
+        case ALARM_STARTUP:
+        {
+            psConfig->ucFlags &= ~(ALARM_FLAG_RISING | ALARM_FLAG_FALLING);
+            psConfig->ucFlags |= (lValue << 1) &
+                                 (ALARM_FLAG_RISING | ALARM_FLAG_FALLING);
+            break;
+        }
+        case ALARM_RISING:
+        {
+            psConfig->lRising = lValue;
+            break;
+        }
+        case ALARM_FALLING:
+        {
+            psConfig->lFalling = lValue;
+            break;
+        }
+        case ALARM_STATUS:
+        {
+            psConfig->ucFlags &= ~ALARM_FLAG_VALID;
+            if(lValue == ALARM_STATUS_VALID)
+            {
+                psConfig->ucFlags |= ALARM_FLAG_VALID;
+            }
+            break;
+        }
+        default:
+        {
+            return;
+        }
+    }
+
+    AlarmSave(ulIndex, &sOld);
+}
+
+//*****************************************************************************
+//
+// Copy the variable of alarm row ulIndex, with its 1.3.6.1 prefix, to plOid
+// and return its length.  A row without a variable returns 0.0.
+//
+//*****************************************************************************
+unsigned long
+AlarmVariableGet(unsigned long ulIndex, long *plOid)
+{
+    tAlarm *psAlarm;
+    unsigned long ulIdx;
+
+    if((ulIndex == 0) || (ulIndex > ALARM_NUM_ROWS) ||
+       (g_psAlarms[ulIndex - 1].ucOidLen == 0))
+    {
+        plOid[0] = 0;
+        plOid[1] = 0;
+        return(2);
+    }
+    psAlarm = &g_psAlarms[ulIndex - 1];
+
+    plOid[0] = 1;
+    plOid[1] = 3;
+    plOid[2] = 6;
+    plOid[3] = 1;
+    for(ulIdx = 0; ulIdx < psAlarm->ucOidLen; ulIdx++)
+    {
+        plOid[ulIdx + 4] = psAlarm->plOid[ulIdx];
+    }
+
+    return(ulIdx + 4);
+}
+
+//*****************************************************************************
+//
+// Check a new alarm variable: it must be below 1.3.6.1 and fit the stored
+// configuration.  Whether it names an integer object is only known when it
+// is sampled.
+//
+//*****************************************************************************
+int
+AlarmVariableValid(const long *plOid, unsigned long ulLen)
+{
+    unsigned char pucOid[ALARM_OID_BYTES];
+
+    if((ulLen <= 4) || (ulLen > ALARM_OID_LEN) || (plOid[0] != 1) ||
+       (plOid[1] != 3) || (plOid[2] != 6) || (plOid[3] != 1))
+    {
+        return(0);
+    }
+
+    return(AlarmOidEncode(plOid + 4, ulLen - 4, pucOid) != 0);
+}
+
+//*****************************************************************************
+//
+// Change the variable of alarm row ulIndex, which has been checked with
+// AlarmVariableValid(), and store the row.
+//
+//*****************************************************************************
+void
+AlarmVariableSet(unsigned long ulIndex, const long *plOid, unsigned long ulLen)
+{
+    tAlarmConfig sOld;
+    tAlarm *psAlarm;
+
+    if((ulIndex == 0) || (ulIndex > ALARM_NUM_ROWS))
+    {
+        return;
+    }
+    psAlarm = &g_psAlarms[ulIndex - 1];
+    sOld = psAlarm->sConfig;
+
+    psAlarm->sConfig.ucOidBytes = AlarmOidEncode(plOid + 4, ulLen - 4,
+                                                 psAlarm->sConfig.pucOid);
+    AlarmOidDecode(psAlarm);
+    AlarmSave(ulIndex, &sOld);
+}
+
+//*****************************************************************************
+//
+// Print the alarm rows on the console.
+//
+//*****************************************************************************
+void
+AlarmPrint(void)
+{
+    long plOid[ALARM_OID_LEN];
+    unsigned long ulIndex, ulLen, ulIdx;
+    struct ip_addr sHop, *psIp;
+    struct eth_addr *psEth;
+    struct netif *psNetif;
+
+    UARTprintf("trap dest:%d.%d.%d.%d samples:%u errors:%u alarms:%u\n",
+               (g_ulAlarmTrapDest >> 24) & 0xff,
+               (g_ulAlarmTrapDest >> 16) & 0xff,
+               (g_ulAlarmTrapDest >> 8) & 0xff, g_ulAlarmTrapDest & 0xff,
+               g_ulAlarmSamples, g_ulAlarmSampleErrors, g_ulAlarmTraps);
+
+    //
+    // Whether the trap destination, or the gateway to it, is still in the
+    // ARP table, which a flood of requests from other senders must not
+    // change.
+    //
+    psNetif = netif_default;
+    if(g_ulAlarmTrapDest && psNetif)
+    {
+        sHop.addr = htonl(g_ulAlarmTrapDest);
+        if(!ip_addr_netcmp(&sHop, &psNetif->ip_addr, &psNetif->netmask))
+        {
+            sHop = psNetif->gw;
+        }
+        UARTprintf("trap dest arp entry:%s\n",
+                   (etharp_find_addr(psNetif, &sHop, &psEth, &psIp) >= 0) ?
+                   "yes" : "no");
+    }
+    UARTprintf("trap retries:%u lost:%u\n", g_ulAlarmTrapRetries,
+               g_ulAlarmTrapsLost);
+
+    for(ulIndex = 1; ulIndex <= ALARM_NUM_ROWS; ulIndex++)
+    {
+        UARTprintf("%d: %s every %ds %s rising>=%d falling<=%d value:%d ",
+                   ulIndex,
+                   (AlarmParamGet(ulIndex, ALARM_STATUS) ==
+                    ALARM_STATUS_VALID) ? "valid" : "invalid",
+                   AlarmParamGet(ulIndex, ALARM_INTERVAL),
+                   (AlarmParamGet(ulIndex, ALARM_SAMPLE_TYPE) ==
+                    ALARM_DELTA) ? "delta" : "absolute",
+                   AlarmParamGet(ulIndex, ALARM_RISING),
+                   AlarmParamGet(ulIndex, ALARM_FALLING),
+                   AlarmParamGet(ulIndex, ALARM_VALUE));
+        ulLen = AlarmVariableGet(ulIndex, plOid);
+        for(ulIdx = 0; ulIdx < ulLen; ulIdx++)
+        {
+            UARTprintf(ulIdx ? ".%u" : "%u", plOid[ulIdx]);
+        }
+        UARTprintf("\n");
+    }
+}
@@ -0,0 +1,82 @@
+//*****************************************************************************
+//
+// alarm.h - threshold alarms on MIB objects, modelled on the RMON alarm group
+//
+//*****************************************************************************
+
+#ifndef __ALARM_H__
+#define __ALARM_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The number of alarm rows, numbered 1 to ALARM_NUM_ROWS, and the longest
+// variable OID they can watch, in sub-identifiers.
+//
+//*****************************************************************************
+#define ALARM_NUM_ROWS          4
+#define ALARM_OID_LEN           24
+
+//*****************************************************************************
+//
+// The alarm parameters, numbered like the columns of the RMON alarmTable
+// where there is an equivalent.
+//
+//*****************************************************************************
+#define ALARM_INDEX             1
+#define ALARM_INTERVAL          2           // seconds between samples
+#define ALARM_VARIABLE          3           // the OID being sampled
+#define ALARM_SAMPLE_TYPE       4           // ALARM_ABSOLUTE or ALARM_DELTA
+#define ALARM_VALUE             5           // the last sample
+#define ALARM_STARTUP           6           // ALARM_STARTUP_*
+#define ALARM_RISING            7           // rising threshold
+#define ALARM_FALLING           8           // falling threshold
+#define ALARM_STATUS            9           // ALARM_STATUS_*
+
+#define ALARM_ABSOLUTE          1
+#define ALARM_DELTA             2
+
+#define ALARM_STARTUP_RISING    1
+#define ALARM_STARTUP_FALLING   2
+#define ALARM_STARTUP_BOTH      3
+
+#define ALARM_STATUS_VALID      1
+#define ALARM_STATUS_INVALID    2
+
+//*****************************************************************************
+//
+// The specific trap numbers sent under the BACON enterprise OID.
+//
+//*****************************************************************************
+#define ALARM_TRAP_RISING       1
+#define ALARM_TRAP_FALLING      2
+
+//*****************************************************************************
+//
+// Prototypes for the APIs.
+//
+//*****************************************************************************
+extern void AlarmInit(void);
+extern void AlarmTimerHandler(void);
+extern long AlarmParamGet(unsigned long ulIndex, unsigned long ulParam);
+extern int AlarmParamValid(unsigned long ulIndex, unsigned long ulParam,
+                           long lValue);
+extern void AlarmParamSet(unsigned long ulIndex, unsigned long ulParam,
+                          long lValue);
+extern unsigned long AlarmVariableGet(unsigned long ulIndex, long *plOid);
+extern int AlarmVariableValid(const long *plOid, unsigned long ulLen);
+extern void AlarmVariableSet(unsigned long ulIndex, const long *plOid,
+                             unsigned long ulLen);
+extern void AlarmTrapDestSet(unsigned long ulIPAddr);
+extern unsigned long AlarmTrapDestGet(void);
+extern void AlarmPrint(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __ALARM_H__
@@ -0,0 +1,1452 @@
+//*****************************************************************************
+//
+// bacon.c - BACON board I/O shared by the private MIB and the interrupt
+// handlers
+//
+//*****************************************************************************
+#include "hw_gpio.h"
+#include "hw_ints.h"
+#include "hw_memmap.h"
+#include "hw_timer.h"
+#include "hw_types.h"
+#include "gpio.h"
+#include "interrupt.h"
+#include "sysctl.h"
+#include "uartstdio.h"
+#include "softeeprom_wrapper.h"
+#include "storage_config.h"
+#include "../lwip-1.3.0/src/include/lwip/opt.h"
+#include "../lwip-1.3.0/src/include/lwip/snmp.h"
+#include "perfcnt.h"
+#include "sched.h"
+#include "bacon.h"
+
+//*****************************************************************************
+//
+// Port indices used by the pin table and the per-port staging registers.
+//
+//*****************************************************************************
+#define BACON_PORT_A            0
+#define BACON_PORT_B            1
+#define BACON_PORT_C            2
+#define BACON_PORT_D            3
+#define BACON_PORT_E            4
+#define BACON_PORT_F            5
+
+//*****************************************************************************
+//
+// Set BACON_FIBER_IRQ to 0 to mirror RX_LOS onto FIBER from the SysTick
+// handler only.
+//
+//*****************************************************************************
+#ifndef BACON_FIBER_IRQ
+#define BACON_FIBER_IRQ         1
+#endif
+
+//*****************************************************************************
+//
+// The number of RX_LOS edges that can be queued between two BACONSample()
+// calls.  Must be a power of two.
+//
+//*****************************************************************************
+#ifndef BACON_EVENT_QUEUE_SIZE
+#define BACON_EVENT_QUEUE_SIZE  8
+#endif
+
+//*****************************************************************************
+//
+// The input filter sample rate, and the depth used for inputs that have none
+// stored in the soft EEPROM.  A depth of n means an input has to hold its new
+// level for n samples before the filtered state follows it.
+//
+//*****************************************************************************
+#ifndef BACON_FILTER_HZ
+#define BACON_FILTER_HZ         1000
+#endif
+#ifndef BACON_FILTER_DEFAULT
+#define BACON_FILTER_DEFAULT    5
+#endif
+
+//*****************************************************************************
+//
+// The serial monitor lines PD4-PD7 count at most BACON_MON_CAP edges per
+// filter sample each.  A line that reaches the cap has its interrupt masked
+// until the next sample, which bounds the interrupt load of a busy line.  The
+// default of 12000 edges per second covers 9600 baud even for alternating
+// bits, and 19200 baud for typical traffic; faster lines only show as active.
+// Counting in a timer's edge count mode instead would need a timer half and
+// a CCP pin for each of the four lines.
+//
+//*****************************************************************************
+#ifndef BACON_MON_CAP
+#define BACON_MON_CAP           12
+#endif
+#if (BACON_MON_CAP < 1) || (BACON_MON_CAP > 255)
+#error BACON_MON_CAP must be between 1 and 255
+#endif
+#define BACON_MON_PINS          (GPIO_PIN_4 | GPIO_PIN_5 | GPIO_PIN_6 |       \
+                                 GPIO_PIN_7)
+
+//*****************************************************************************
+//
+// Pin flags.
+//
+//*****************************************************************************
+#define BACON_PIN_OUTPUT        0x01
+
+//*****************************************************************************
+//
+// Describes where a BACON pin lives.
+//
+//*****************************************************************************
+typedef struct
+{
+    unsigned char ucPort;
+    unsigned char ucPin;
+    unsigned char ucFlags;
+}
+tBACONPin;
+
+//*****************************************************************************
+//
+// The GPIO base address of each port index.
+//
+//*****************************************************************************
+static const unsigned long g_pulBACONPortBase[BACON_NUM_PORTS] =
+{
+    GPIO_PORTA_BASE, GPIO_PORTB_BASE, GPIO_PORTC_BASE,
+    GPIO_PORTD_BASE, GPIO_PORTE_BASE, GPIO_PORTF_BASE
+};
+
+//*****************************************************************************
+//
+// The BACON pins, indexed by sensor id - 1.
+//
+//*****************************************************************************
+static const tBACONPin g_psBACONPins[BACON_NUM_PINS] =
+{
+    { BACON_PORT_E, GPIO_PIN_3, BACON_PIN_OUTPUT }, // 1 FIBER
+    { BACON_PORT_B, GPIO_PIN_2, 0 },                // 2 RX_LOS
+    { BACON_PORT_B, GPIO_PIN_0, BACON_PIN_OUTPUT }, // 3 BAUD1_1
+    { BACON_PORT_F, GPIO_PIN_1, BACON_PIN_OUTPUT }, // 4 BAUD1_2
+    { BACON_PORT_F, GPIO_PIN_2, BACON_PIN_OUTPUT }, // 5 BAUD1_3
+    { BACON_PORT_F, GPIO_PIN_3, BACON_PIN_OUTPUT }, // 6 BAUD1_4
+    { BACON_PORT_D, GPIO_PIN_3, BACON_PIN_OUTPUT }, // 7 BAUD1_1_R
+    { BACON_PORT_D, GPIO_PIN_2, BACON_PIN_OUTPUT }, // 8 BAUD1_2_R
+    { BACON_PORT_D, GPIO_PIN_1, BACON_PIN_OUTPUT }, // 9 BAUD1_3_R
+    { BACON_PORT_D, GPIO_PIN_0, BACON_PIN_OUTPUT }, // 10 BAUD1_4_R
+    { BACON_PORT_A, GPIO_PIN_7, BACON_PIN_OUTPUT }, // 11 BAUD2_1
+    { BACON_PORT_A, GPIO_PIN_6, BACON_PIN_OUTPUT }, // 12 BAUD2_2
+    { BACON_PORT_A, GPIO_PIN_5, BACON_PIN_OUTPUT }, // 13 BAUD2_3
+    { BACON_PORT_A, GPIO_PIN_4, BACON_PIN_OUTPUT }, // 14 BAUD2_4
+    { BACON_PORT_E, GPIO_PIN_4, BACON_PIN_OUTPUT }, // 15 BAUD2_1_R
+    { BACON_PORT_E, GPIO_PIN_5, BACON_PIN_OUTPUT }, // 16 BAUD2_2_R
+    { BACON_PORT_E, GPIO_PIN_6, BACON_PIN_OUTPUT }, // 17 BAUD2_3_R
+    { BACON_PORT_E, GPIO_PIN_7, BACON_PIN_OUTPUT }, // 18 BAUD2_4_R
+    { BACON_PORT_C, GPIO_PIN_7, 0 },                // 19 TP_Link1
+    { BACON_PORT_C, GPIO_PIN_6, 0 },                // 20 TP_Link2
+    { BACON_PORT_C, GPIO_PIN_5, 0 },                // 21 TP_Link3
+    { BACON_PORT_C, GPIO_PIN_4, 0 },                // 22 TP_Link4
+    { BACON_PORT_B, GPIO_PIN_1, 0 },                // 23 Far_TP_Link1
+    { BACON_PORT_B, GPIO_PIN_3, 0 },                // 24 Far_TP_Link2
+    { BACON_PORT_E, GPIO_PIN_0, 0 },                // 25 Far_TP_Link3
+    { BACON_PORT_E, GPIO_PIN_1, 0 },                // 26 Far_TP_Link4
+    { BACON_PORT_A, GPIO_PIN_2, 0 },                // 27 STATUS1
+    { BACON_PORT_A, GPIO_PIN_3, 0 },                // 28 STATUS2
+    { BACON_PORT_D, GPIO_PIN_6, 0 },                // 29 RXD1_MON
+    { BACON_PORT_D, GPIO_PIN_7, 0 },                // 30 TXD1_MON
+    { BACON_PORT_D, GPIO_PIN_4, 0 },                // 31 RXD2_MON
+    { BACON_PORT_D, GPIO_PIN_5, 0 },                // 32 TXD2_MON
+};
+
+//*****************************************************************************
+//
+// The link inputs with flap statistics, and the level of each that means the
+// link is up.  RX_LOS is active high, the link inputs are assumed to be high
+// while the link is up.
+//
+//*****************************************************************************
+static const unsigned char g_pucBACONLinkId[BACON_NUM_LINKS] =
+{
+    BACON_ID_TP_LINK1, 20, 21, 22, 23, 24, 25, 26, BACON_ID_RX_LOS
+};
+static const unsigned char g_pucBACONLinkUpLevel[BACON_NUM_LINKS] =
+{
+    1, 1, 1, 1, 1, 1, 1, 1, 0
+};
+
+//*****************************************************************************
+//
+// The first pin id of each baud rate selector; the four pins of a selector
+// have consecutive ids.
+//
+//*****************************************************************************
+static const unsigned char g_pucBACONBaudFirstId[BACON_NUM_BAUD] =
+{
+    3, 7, 11, 15
+};
+
+//*****************************************************************************
+//
+// The selector code of each enumerated baud rate, indexed by rate - 1.  No
+// datasheet of the serial converter or strapping table of the board was at
+// hand, so the codes simply count up from 0 in rate order.  This is an
+// assumption that still has to be checked on the board, which is why
+// BACON_BAUD_WRITABLE is 0: the rates read back may be wrong, but no SET
+// drives an unverified code onto the converter.  Once the table is filled
+// from the converter's datasheet, cite it here and enable the writes.
+//
+//*****************************************************************************
+static const unsigned char g_pucBACONBaudCode[BACON_BAUD_115200] =
+{
+    0x0,    // 1200
+    0x1,    // 2400
+    0x2,    // 4800
+    0x3,    // 9600
+    0x4,    // 19200
+    0x5,    // 38400
+    0x6,    // 57600
+    0x7,    // 115200
+};
+
+//*****************************************************************************
+//
+// Writes staged by the SNMP set pass, one mask/value pair per port.  They
+// are applied together by BACONSetCommit() once every varbind of the
+// SetRequest has passed set_test(), so that e.g. the four BAUD1 pins change
+// in a single register write instead of passing through intermediate codes.
+//
+//*****************************************************************************
+static unsigned char g_pucBACONStageMask[BACON_NUM_PORTS];
+static unsigned char g_pucBACONStageVal[BACON_NUM_PORTS];
+
+//*****************************************************************************
+//
+// RAM shadow of the output pins of each port.  Outputs are only ever driven
+// through BACONPinWrite() and BACONSetCommit(), so the shadow is the
+// configured state and output pins are never read back from the port.
+//
+//*****************************************************************************
+static unsigned char g_pucBACONShadow[BACON_NUM_PORTS];
+
+//*****************************************************************************
+//
+// The input pins of each port.  Ports without inputs are not read at all.
+//
+//*****************************************************************************
+static unsigned char g_pucBACONPortInputs[BACON_NUM_PORTS];
+
+//*****************************************************************************
+//
+// The input pins in BACONSnapshot() layout, the raw inputs of the last filter
+// sample and the filtered input state.
+//
+//*****************************************************************************
+static unsigned long g_ulBACONInputMask;
+static unsigned long g_ulBACONRawState;
+static unsigned long g_ulBACONInputState;
+
+//*****************************************************************************
+//
+// The integrator of every input, counting from 0 up to its filter depth, and
+// the filter depths.  Both are indexed by pin id - 1.
+//
+//*****************************************************************************
+static unsigned char g_pucBACONFilterCount[BACON_NUM_PINS];
+static unsigned char g_pucBACONFilterDepth[BACON_NUM_PINS];
+
+//*****************************************************************************
+//
+// The state generation, bumped on every input change, and the sysUpTime of
+// the last change.
+//
+//*****************************************************************************
+static unsigned long g_ulBACONGeneration;
+static unsigned long g_ulBACONLastChange;
+
+//*****************************************************************************
+//
+// The snapshot the last changed-bits read was taken against, and changes
+// latched since then.
+//
+//*****************************************************************************
+static unsigned long g_ulBACONChangedRef;
+static unsigned long g_ulBACONChangedLatch;
+
+//*****************************************************************************
+//
+// Set transaction statistics.
+//
+//*****************************************************************************
+static unsigned long g_ulBACONSetStart;
+static unsigned long g_ulBACONSetCommits;
+static unsigned long g_ulBACONSetAborts;
+static unsigned long g_ulBACONPortWrites;
+static tPerfStat g_sBACONSetLatency = { 0, 0, 0xFFFFFFFF, 0, 0 };
+
+//*****************************************************************************
+//
+// RX_LOS edges queued by BACONRxLosIntHandler().  The interrupt handler only
+// advances the write index and BACONEventGet() only the read index.
+//
+//*****************************************************************************
+static tBACONEvent g_psBACONEvents[BACON_EVENT_QUEUE_SIZE];
+static volatile unsigned long g_ulBACONEventWrite;
+static volatile unsigned long g_ulBACONEventRead;
+static unsigned long g_ulBACONEventOverflows;
+
+//*****************************************************************************
+//
+// FIBER mirroring statistics.  The latency is measured from the cycle
+// counter sample at handler entry to the FIBER write, so the roughly 12
+// cycles of exception entry are not included.
+//
+//*****************************************************************************
+static unsigned long g_ulBACONFiberEdges;
+static unsigned long g_ulBACONFiberPolled;
+static tPerfStat g_sBACONFiberLatency = { 0, 0, 0xFFFFFFFF, 0, 0 };
+
+//*****************************************************************************
+//
+// Serial monitor line counters, indexed by line (pin id - BACON_ID_RXD1_MON).
+// The edge and saturation counts are free running; the rate is the number of
+// edges in the last complete second.
+//
+//*****************************************************************************
+static volatile unsigned long g_pulBACONMonEdges[BACON_NUM_MON];
+static unsigned long g_pulBACONMonSaturated[BACON_NUM_MON];
+static unsigned long g_pulBACONMonRate[BACON_NUM_MON];
+static unsigned long g_pulBACONMonLast[BACON_NUM_MON];
+static unsigned char g_pucBACONMonWindow[BACON_NUM_MON];
+static unsigned long g_ulBACONMonTicks;
+
+//*****************************************************************************
+//
+// Flap statistics of a link.  Times are in sysUpTime ticks; the time spent in
+// the current state since ulSince is not yet added to ulUpTime or ulDownTime.
+//
+//*****************************************************************************
+typedef struct
+{
+    unsigned long ulTransitions;
+    unsigned long ulUpTime;
+    unsigned long ulDownTime;
+    unsigned long ulSince;
+    unsigned long ulLastChange;
+}
+tBACONLink;
+
+static tBACONLink g_psBACONLinks[BACON_NUM_LINKS];
+
+//*****************************************************************************
+//
+// The history ring.  Record n is kept in slot n % BACON_HISTORY_DEPTH, so a
+// record is found from its sequence number without searching.
+//
+//*****************************************************************************
+static tBACONHistory g_psBACONHistory[BACON_HISTORY_DEPTH];
+static volatile unsigned long g_ulBACONHistorySeq;
+
+//*****************************************************************************
+//
+// The newest record that is a row of baconHistoryTable.  The rows are added
+// by BACONHistoryTask() rather than by the filter timer, which may interrupt
+// the SNMP agent in the middle of a walk of the table.
+//
+//*****************************************************************************
+static unsigned long g_ulBACONHistoryRows;
+
+//*****************************************************************************
+//
+// Discard any staged writes.
+//
+//*****************************************************************************
+static void
+BACONStageClear(void)
+{
+    int i;
+
+    for(i = 0; i < BACON_NUM_PORTS; i++)
+    {
+        g_pucBACONStageMask[i] = 0;
+        g_pucBACONStageVal[i] = 0;
+    }
+}
+
+//*****************************************************************************
+//
+// Initialize the BACON I/O state.  Must be called after the GPIO ports have
+// been configured.
+//
+//*****************************************************************************
+void
+BACONInit(void)
+{
+    const tBACONPin *psPin;
+    unsigned char pucOutputs[BACON_NUM_PORTS];
+    int i;
+
+    for(i = 0; i < BACON_NUM_PORTS; i++)
+    {
+        g_pucBACONPortInputs[i] = 0;
+        pucOutputs[i] = 0;
+    }
+
+    g_ulBACONInputMask = 0;
+    psPin = g_psBACONPins;
+    for(i = 0; i < BACON_NUM_PINS; i++, psPin++)
+    {
+        if(psPin->ucFlags & BACON_PIN_OUTPUT)
+        {
+            pucOutputs[psPin->ucPort] |= psPin->ucPin;
+        }
+        else
+        {
+            g_pucBACONPortInputs[psPin->ucPort] |= psPin->ucPin;
+            g_ulBACONInputMask |= 1 << i;
+        }
+    }
+
+    //
+    // Seed the shadow with whatever the outputs came up as.  This is the only
+    // time they are read back.
+    //
+    for(i = 0; i < BACON_NUM_PORTS; i++)
+    {
+        g_pucBACONShadow[i] = GPIOPinRead(g_pulBACONPortBase[i],
+                                          pucOutputs[i]);
+    }
+
+    //
+    // Start out with the filters settled on the current input levels.
+    //
+    g_ulBACONChangedRef = BACONRawSnapshot();
+    g_ulBACONRawState = g_ulBACONChangedRef & g_ulBACONInputMask;
+    g_ulBACONInputState = g_ulBACONRawState;
+    for(i = 0; i < BACON_NUM_PINS; i++)
+    {
+        g_pucBACONFilterDepth[i] = BACON_FILTER_DEFAULT;
+        g_pucBACONFilterCount[i] =
+            (g_ulBACONRawState & (1 << i)) ? BACON_FILTER_DEFAULT : 0;
+    }
+
+    //
+    // Count the edges of the serial monitor lines.
+    //
+    GPIOIntTypeSet(GPIO_PORTD_BASE, BACON_MON_PINS, GPIO_BOTH_EDGES);
+    GPIOPinIntClear(GPIO_PORTD_BASE, BACON_MON_PINS);
+    GPIOPinIntEnable(GPIO_PORTD_BASE, BACON_MON_PINS);
+    IntEnable(INT_GPIOD);
+
+    //
+    // Sample the inputs from timer 0 A.
+    //
+    SysCtlPeripheralEnable(SYSCTL_PERIPH_TIMER0);
+    HWREG(TIMER0_BASE + TIMER_O_CTL) &= ~TIMER_CTL_TAEN;
+    HWREG(TIMER0_BASE + TIMER_O_CFG) = TIMER_CFG_32_BIT_TIMER;
+    HWREG(TIMER0_BASE + TIMER_O_TAMR) = TIMER_TAMR_TAMR_PERIOD;
+    HWREG(TIMER0_BASE + TIMER_O_TAILR) = SysCtlClockGet() / BACON_FILTER_HZ - 1;
+    HWREG(TIMER0_BASE + TIMER_O_IMR) |= TIMER_IMR_TATOIM;
+    HWREG(TIMER0_BASE + TIMER_O_CTL) |= TIMER_CTL_TASTALL | TIMER_CTL_TAEN;
+    IntEnable(INT_TIMER0A);
+
+#if BACON_FIBER_IRQ
+    //
+    // Mirror RX_LOS onto FIBER on both edges.
+    //
+    GPIOIntTypeSet(GPIO_PORTB_BASE, GPIO_PIN_2, GPIO_BOTH_EDGES);
+    GPIOPinIntClear(GPIO_PORTB_BASE, GPIO_PIN_2);
+    GPIOPinIntEnable(GPIO_PORTB_BASE, GPIO_PIN_2);
+    IntEnable(INT_GPIOB);
+#endif
+}
+
+//*****************************************************************************
+//
+// The interrupt handler for GPIO port B.  Copies RX_LOS (PB2) to FIBER (PE3)
+// and queues the edge for BACONSample().  The pins are accessed through the
+// masked data registers so that nothing else on either port is touched.
+//
+//*****************************************************************************
+void
+BACONRxLosIntHandler(void)
+{
+    unsigned long ulStart, ulLevel, ulWrite;
+    tBACONEvent *psEvent;
+
+    ulStart = PerfCountGet();
+
+    HWREG(GPIO_PORTB_BASE + GPIO_O_ICR) = GPIO_PIN_2;
+    ulLevel = HWREG(GPIO_PORTB_BASE + GPIO_O_DATA + (GPIO_PIN_2 << 2));
+    HWREG(GPIO_PORTE_BASE + GPIO_O_DATA + (GPIO_PIN_3 << 2)) =
+        ulLevel ? GPIO_PIN_3 : 0;
+
+    PerfStatUpdate(&g_sBACONFiberLatency, PerfCountGet() - ulStart);
+
+    //
+    // This handler runs at the highest priority, so nothing can modify the
+    // shadow between these two statements.
+    //
+    if(ulLevel)
+    {
+        g_pucBACONShadow[BACON_PORT_E] |= GPIO_PIN_3;
+    }
+    else
+    {
+        g_pucBACONShadow[BACON_PORT_E] &= ~GPIO_PIN_3;
+    }
+    g_ulBACONFiberEdges++;
+
+    ulWrite = g_ulBACONEventWrite;
+    if((ulWrite - g_ulBACONEventRead) >= BACON_EVENT_QUEUE_SIZE)
+    {
+        g_ulBACONEventOverflows++;
+        return;
+    }
+    psEvent = &g_psBACONEvents[ulWrite & (BACON_EVENT_QUEUE_SIZE - 1)];
+    psEvent->ulCycles = ulStart;
+    snmp_get_sysuptime(&psEvent->ulUpTime);
+    psEvent->ucId = BACON_ID_RX_LOS;
+    psEvent->ucLevel = ulLevel ? 1 : 0;
+    g_ulBACONEventWrite = ulWrite + 1;
+}
+
+//*****************************************************************************
+//
+// Take the oldest queued edge.  Returns 0 if the queue is empty.
+//
+//*****************************************************************************
+int
+BACONEventGet(tBACONEvent *psEvent)
+{
+    unsigned long ulRead;
+
+    ulRead = g_ulBACONEventRead;
+    if(ulRead == g_ulBACONEventWrite)
+    {
+        return(0);
+    }
+
+    *psEvent = g_psBACONEvents[ulRead & (BACON_EVENT_QUEUE_SIZE - 1)];
+    g_ulBACONEventRead = ulRead + 1;
+    return(1);
+}
+
+//*****************************************************************************
+//
+// The interrupt handler for GPIO port D.  Counts the edges of the serial
+// monitor lines, PD4 (RXD2_MON) to PD7 (TXD1_MON).
+//
+//*****************************************************************************
+void
+BACONMonIntHandler(void)
+{
+    unsigned long ulStatus, ulLine;
+
+    ulStatus = HWREG(GPIO_PORTD_BASE + GPIO_O_MIS) & BACON_MON_PINS;
+    HWREG(GPIO_PORTD_BASE + GPIO_O_ICR) = ulStatus;
+
+    for(ulLine = 0; ulLine < BACON_NUM_MON; ulLine++)
+    {
+        const tBACONPin *psPin;
+
+        psPin = &g_psBACONPins[BACON_ID_RXD1_MON - 1 + ulLine];
+        if(!(ulStatus & psPin->ucPin))
+        {
+            continue;
+        }
+
+        g_pulBACONMonEdges[ulLine]++;
+        if(++g_pucBACONMonWindow[ulLine] >= BACON_MON_CAP)
+        {
+            HWREG(GPIO_PORTD_BASE + GPIO_O_IM) &= ~psPin->ucPin;
+            g_pulBACONMonSaturated[ulLine]++;
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Restart the per-sample edge windows of the serial monitor lines, and
+// update the rates once a second.  Called from the filter timer.
+//
+//*****************************************************************************
+static void
+BACONMonTick(void)
+{
+    unsigned long ulLine, ulEdges;
+    tBoolean bIntsOff;
+
+    bIntsOff = IntMasterDisable();
+    for(ulLine = 0; ulLine < BACON_NUM_MON; ulLine++)
+    {
+        g_pucBACONMonWindow[ulLine] = 0;
+    }
+    HWREG(GPIO_PORTD_BASE + GPIO_O_IM) |= BACON_MON_PINS;
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+
+    if(++g_ulBACONMonTicks < BACON_FILTER_HZ)
+    {
+        return;
+    }
+    g_ulBACONMonTicks = 0;
+
+    for(ulLine = 0; ulLine < BACON_NUM_MON; ulLine++)
+    {
+        ulEdges = g_pulBACONMonEdges[ulLine];
+        g_pulBACONMonRate[ulLine] = ulEdges - g_pulBACONMonLast[ulLine];
+        g_pulBACONMonLast[ulLine] = ulEdges;
+    }
+}
+
+//*****************************************************************************
+//
+// Return the edge count, edges in the last second, or the number of filter
+// samples in which the edge cap was reached, of serial monitor line ulLine.
+//
+//*****************************************************************************
+unsigned long
+BACONMonEdgesGet(unsigned long ulLine)
+{
+    return((ulLine < BACON_NUM_MON) ? g_pulBACONMonEdges[ulLine] : 0);
+}
+
+unsigned long
+BACONMonRateGet(unsigned long ulLine)
+{
+    return((ulLine < BACON_NUM_MON) ? g_pulBACONMonRate[ulLine] : 0);
+}
+
+unsigned long
+BACONMonSaturatedGet(unsigned long ulLine)
+{
+    return((ulLine < BACON_NUM_MON) ? g_pulBACONMonSaturated[ulLine] : 0);
+}
+
+//*****************************************************************************
+//
+// Load the filter depths from the soft EEPROM.  Must be called after the soft
+// EEPROM has been initialized; until then the default depth is used.
+//
+//*****************************************************************************
+void
+BACONFilterLoad(void)
+{
+    unsigned char pucDepth[BACON_NUM_PINS];
+    int i;
+
+    SoftEEPROM_WrapperRead(EEPROM_BACON_FILTER_ADDR, BACON_NUM_PINS, pucDepth);
+    for(i = 0; i < BACON_NUM_PINS; i++)
+    {
+        if(pucDepth[i] <= BACON_FILTER_MAX_DEPTH)
+        {
+            g_pucBACONFilterDepth[i] = pucDepth[i];
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Return the filter depth of pin ucId, in samples.
+//
+//*****************************************************************************
+unsigned long
+BACONFilterDepthGet(unsigned char ucId)
+{
+    if((ucId == 0) || (ucId > BACON_NUM_PINS))
+    {
+        return(0);
+    }
+
+    return(g_pucBACONFilterDepth[ucId - 1]);
+}
+
+//*****************************************************************************
+//
+// Change the filter depth of input ucId and store it in the soft EEPROM.  The
+// caller has checked the depth against BACON_FILTER_MAX_DEPTH.
+//
+//*****************************************************************************
+void
+BACONFilterDepthSet(unsigned char ucId, unsigned long ulDepth)
+{
+    unsigned char ucDepth;
+
+    if((ucId == 0) || (ucId > BACON_NUM_PINS) ||
+       !(g_ulBACONInputMask & (1 << (ucId - 1))))
+    {
+        return;
+    }
+
+    ucDepth = (unsigned char)ulDepth;
+    if(g_pucBACONFilterDepth[ucId - 1] != ucDepth)
+    {
+        g_pucBACONFilterDepth[ucId - 1] = ucDepth;
+        SoftEEPROM_WrapperWrite(EEPROM_BACON_FILTER_ADDR + ucId - 1, 1,
+                                &ucDepth);
+    }
+}
+
+//*****************************************************************************
+//
+// Account the filtered changes ulChanged, seen at sysUpTime ulNow, to the
+// link statistics.  g_ulBACONInputState already holds the new levels.
+//
+//*****************************************************************************
+static void
+BACONLinkUpdate(unsigned long ulChanged, unsigned long ulNow)
+{
+    tBACONLink *psLink;
+    unsigned long ulBit;
+    int i;
+
+    psLink = g_psBACONLinks;
+    for(i = 0; i < BACON_NUM_LINKS; i++, psLink++)
+    {
+        ulBit = 1 << (g_pucBACONLinkId[i] - 1);
+        if(!(ulChanged & ulBit))
+        {
+            continue;
+        }
+
+        //
+        // The time since the last change was spent in the opposite of the
+        // new state.
+        //
+        if(((g_ulBACONInputState & ulBit) ? 1 : 0) ==
+           g_pucBACONLinkUpLevel[i])
+        {
+            psLink->ulDownTime += ulNow - psLink->ulSince;
+        }
+        else
+        {
+            psLink->ulUpTime += ulNow - psLink->ulSince;
+        }
+        psLink->ulSince = ulNow;
+        psLink->ulLastChange = ulNow;
+        psLink->ulTransitions++;
+    }
+}
+
+//*****************************************************************************
+//
+// Return the flap statistics of the link on pin ucId.  ulWhich is one of
+// BACON_LINK_TRANSITIONS, BACON_LINK_UP_TIME, BACON_LINK_DOWN_TIME or
+// BACON_LINK_LAST_CHANGE; the times are in sysUpTime ticks.  Returns 0 if
+// ucId is not a link.
+//
+//*****************************************************************************
+unsigned long
+BACONLinkGet(unsigned char ucId, unsigned long ulWhich)
+{
+    tBACONLink sLink;
+    unsigned long ulNow, ulCurrent, ulState;
+    tBoolean bIntsOff;
+    int i, bUp;
+
+    for(i = 0; i < BACON_NUM_LINKS; i++)
+    {
+        if(g_pucBACONLinkId[i] == ucId)
+        {
+            break;
+        }
+    }
+    if(i == BACON_NUM_LINKS)
+    {
+        return(0);
+    }
+
+    //
+    // The filter timer updates the record and the state together, so take
+    // both at once.
+    //
+    bIntsOff = IntMasterDisable();
+    sLink = g_psBACONLinks[i];
+    ulState = g_ulBACONInputState;
+    snmp_get_sysuptime(&ulNow);
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+
+    ulCurrent = ulNow - sLink.ulSince;
+    bUp = (((ulState >> (ucId - 1)) & 1) == g_pucBACONLinkUpLevel[i]);
+
+    switch(ulWhich)
+    {
+        case BACON_LINK_TRANSITIONS:
+        {
+            return(sLink.ulTransitions);
+        }
+        case BACON_LINK_UP_TIME:
+        {
+            return(sLink.ulUpTime + (bUp ? ulCurrent : 0));
+        }
+        case BACON_LINK_DOWN_TIME:
+        {
+            return(sLink.ulDownTime + (bUp ? 0 : ulCurrent));
+        }
+        case BACON_LINK_LAST_CHANGE:
+        {
+            return(sLink.ulLastChange);
+        }
+        default:
+        {
+            return(0);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Record the filtered changes ulChanged, seen at sysUpTime ulNow, in the
+// history ring, overwriting the oldest record once the ring is full.
+//
+//*****************************************************************************
+static void
+BACONHistoryAdd(unsigned long ulChanged, unsigned long ulNow)
+{
+    tBACONHistory *psRec;
+
+    g_ulBACONHistorySeq++;
+    psRec = &g_psBACONHistory[g_ulBACONHistorySeq & (BACON_HISTORY_DEPTH - 1)];
+    psRec->ulSeq = g_ulBACONHistorySeq;
+    psRec->ulUpTime = ulNow;
+    psRec->ulBits = BACONSnapshot();
+    psRec->ulChanged = ulChanged;
+
+    SchedPost(SCHED_TASK_BACON);
+}
+
+//*****************************************************************************
+//
+// The BACON task.  Adds the records logged since it last ran as rows of
+// baconHistoryTable, skipping those already overwritten in the ring.
+//
+//*****************************************************************************
+int
+BACONHistoryTask(void)
+{
+    unsigned long ulSeq;
+
+    ulSeq = g_ulBACONHistorySeq;
+    if((ulSeq - g_ulBACONHistoryRows) > BACON_HISTORY_DEPTH)
+    {
+        g_ulBACONHistoryRows = ulSeq - BACON_HISTORY_DEPTH;
+    }
+    while(g_ulBACONHistoryRows != ulSeq)
+    {
+        BACON_history_add(++g_ulBACONHistoryRows);
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Copy history record ulSeq to *psRec, which may be 0 to only check for it.
+// Returns 0 if the record is not, or no longer, in the ring.  The filter
+// timer may overwrite the slot at any time, so it is copied with interrupts
+// masked.
+//
+//*****************************************************************************
+int
+BACONHistoryGet(unsigned long ulSeq, tBACONHistory *psRec)
+{
+    const tBACONHistory *psSlot;
+    tBoolean bIntsOff;
+    int iFound;
+
+    psSlot = &g_psBACONHistory[ulSeq & (BACON_HISTORY_DEPTH - 1)];
+    bIntsOff = IntMasterDisable();
+    iFound = (ulSeq != 0) && (psSlot->ulSeq == ulSeq);
+    if(iFound && psRec)
+    {
+        *psRec = *psSlot;
+    }
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+
+    return(iFound);
+}
+
+//*****************************************************************************
+//
+// The interrupt handler for timer 0 A.  Samples the inputs and runs them
+// through their integrators; a change of the filtered state is what bumps
+// the state generation.  The filtered state is a single word, so the SNMP
+// agent it may interrupt always reads a consistent set of inputs.
+//
+//*****************************************************************************
+void
+BACONFilterIntHandler(void)
+{
+    unsigned long ulRaw, ulFiltered, ulBit, ulChanged;
+    unsigned char *pucCount;
+    unsigned char ucDepth;
+    int i;
+
+    HWREG(TIMER0_BASE + TIMER_O_ICR) = TIMER_ICR_TATOCINT;
+
+    BACONMonTick();
+
+    ulRaw = BACONRawSnapshot() & g_ulBACONInputMask;
+    g_ulBACONRawState = ulRaw;
+
+    ulFiltered = g_ulBACONInputState;
+    pucCount = g_pucBACONFilterCount;
+    for(i = 0, ulBit = 1; i < BACON_NUM_PINS; i++, ulBit <<= 1, pucCount++)
+    {
+        if(!(g_ulBACONInputMask & ulBit))
+        {
+            continue;
+        }
+
+        ucDepth = g_pucBACONFilterDepth[i];
+        if(ulRaw & ulBit)
+        {
+            if(*pucCount < ucDepth)
+            {
+                (*pucCount)++;
+            }
+            if(*pucCount >= ucDepth)
+            {
+                *pucCount = ucDepth;
+                ulFiltered |= ulBit;
+            }
+        }
+        else
+        {
+            if(*pucCount > ucDepth)
+            {
+                *pucCount = ucDepth;
+            }
+            if(*pucCount)
+            {
+                (*pucCount)--;
+            }
+            if(*pucCount == 0)
+            {
+                ulFiltered &= ~ulBit;
+            }
+        }
+    }
+
+    ulChanged = ulFiltered ^ g_ulBACONInputState;
+    if(ulChanged)
+    {
+        g_ulBACONInputState = ulFiltered;
+        g_ulBACONChangedLatch |= ulChanged;
+        g_ulBACONGeneration++;
+        snmp_get_sysuptime(&g_ulBACONLastChange);
+        BACONLinkUpdate(ulChanged, g_ulBACONLastChange);
+        BACONHistoryAdd(ulChanged, g_ulBACONLastChange);
+    }
+}
+
+//*****************************************************************************
+//
+// Polled fallback for the FIBER mirroring.  RX_LOS is read from the pin
+// rather than taken from the last filter sample, which may be up to a
+// millisecond older than an edge BACONRxLosIntHandler() has already mirrored.
+// The compare and write are done with interrupts masked since the handler
+// modifies the same shadow byte.  Returns the level written to FIBER, or -1
+// if it was already in step with RX_LOS.
+//
+//*****************************************************************************
+long
+BACONFiberPoll(void)
+{
+    unsigned long ulLevel;
+    tBoolean bIntsOff;
+    long lRet;
+
+    lRet = -1;
+    bIntsOff = IntMasterDisable();
+    ulLevel = HWREG(GPIO_PORTB_BASE + GPIO_O_DATA + (GPIO_PIN_2 << 2)) ? 1 : 0;
+    if(ulLevel != ((g_pucBACONShadow[BACON_PORT_E] & GPIO_PIN_3) ? 1 : 0))
+    {
+        if(ulLevel)
+        {
+            g_pucBACONShadow[BACON_PORT_E] |= GPIO_PIN_3;
+        }
+        else
+        {
+            g_pucBACONShadow[BACON_PORT_E] &= ~GPIO_PIN_3;
+        }
+        HWREG(GPIO_PORTE_BASE + GPIO_O_DATA + (GPIO_PIN_3 << 2)) =
+            g_pucBACONShadow[BACON_PORT_E];
+        g_ulBACONFiberPolled++;
+        lRet = ulLevel;
+    }
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+
+    return(lRet);
+}
+
+//*****************************************************************************
+//
+// Collect the queued input edges.  Called periodically from the SysTick
+// handler.  A pulse shorter than one filter sample is not seen by the
+// filter, so for unfiltered inputs the edges are latched as changed bits
+// here; they do not count as a change of the filtered state.
+//
+//*****************************************************************************
+void
+BACONSample(void)
+{
+    unsigned long ulPulses;
+    tBACONEvent sEvent;
+
+    ulPulses = 0;
+    while(BACONEventGet(&sEvent))
+    {
+        if(g_pucBACONFilterDepth[sEvent.ucId - 1] == 0)
+        {
+            ulPulses |= 1 << (sEvent.ucId - 1);
+        }
+    }
+
+    g_ulBACONChangedLatch |= ulPulses;
+}
+
+//*****************************************************************************
+//
+// Return the state generation.
+//
+//*****************************************************************************
+unsigned long
+BACONGenerationGet(void)
+{
+    return(g_ulBACONGeneration);
+}
+
+//*****************************************************************************
+//
+// Return the sysUpTime of the last input change, 0 if none was seen.
+//
+//*****************************************************************************
+unsigned long
+BACONLastChangeGet(void)
+{
+    return(g_ulBACONLastChange);
+}
+
+//*****************************************************************************
+//
+// Called when a SetRequest starts testing its varbinds.
+//
+//*****************************************************************************
+void
+BACONSetBegin(void)
+{
+    BACONStageClear();
+    g_ulBACONSetStart = PerfCountGet();
+}
+
+//*****************************************************************************
+//
+// Stage a write of ulValue (zero or non-zero) to output pin ucId.  Input
+// pins are ignored; set_test() never accepts them.
+//
+//*****************************************************************************
+void
+BACONSetStage(unsigned char ucId, unsigned long ulValue)
+{
+    const tBACONPin *psPin;
+
+    if((ucId == 0) || (ucId > BACON_NUM_PINS))
+    {
+        return;
+    }
+
+    psPin = &g_psBACONPins[ucId - 1];
+    if(!(psPin->ucFlags & BACON_PIN_OUTPUT))
+    {
+        return;
+    }
+
+    g_pucBACONStageMask[psPin->ucPort] |= psPin->ucPin;
+    if(ulValue)
+    {
+        g_pucBACONStageVal[psPin->ucPort] |= psPin->ucPin;
+    }
+    else
+    {
+        g_pucBACONStageVal[psPin->ucPort] &= ~psPin->ucPin;
+    }
+}
+
+//*****************************************************************************
+//
+// Apply the staged writes, one masked register write per touched port.
+//
+//*****************************************************************************
+void
+BACONSetCommit(void)
+{
+    tBoolean bIntsOff;
+    unsigned long ulWrites;
+    int i;
+
+    ulWrites = 0;
+
+    //
+    // Keep the per-port writes back to back so that no interrupt handler
+    // runs between two ports of the same SetRequest.
+    //
+    bIntsOff = IntMasterDisable();
+    for(i = 0; i < BACON_NUM_PORTS; i++)
+    {
+        if(g_pucBACONStageMask[i])
+        {
+            GPIOPinWrite(g_pulBACONPortBase[i], g_pucBACONStageMask[i],
+                         g_pucBACONStageVal[i]);
+            g_pucBACONShadow[i] = ((g_pucBACONShadow[i] &
+                                    ~g_pucBACONStageMask[i]) |
+                                   g_pucBACONStageVal[i]);
+            ulWrites++;
+        }
+    }
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+
+    if(ulWrites)
+    {
+        PerfStatUpdate(&g_sBACONSetLatency,
+                       PerfCountGet() - g_ulBACONSetStart);
+        g_ulBACONSetCommits++;
+        g_ulBACONPortWrites += ulWrites;
+    }
+
+    BACONStageClear();
+}
+
+//*****************************************************************************
+//
+// Called when a SetRequest is rejected; nothing staged so far is applied.
+//
+//*****************************************************************************
+void
+BACONSetAbort(void)
+{
+    BACONStageClear();
+    g_ulBACONSetAborts++;
+}
+
+//*****************************************************************************
+//
+// Read the level (0 or 1) of BACON pin ucId.  Outputs are read from the
+// shadow.
+//
+//*****************************************************************************
+unsigned long
+BACONPinRead(unsigned char ucId)
+{
+    const tBACONPin *psPin;
+
+    if((ucId == 0) || (ucId > BACON_NUM_PINS))
+    {
+        return(0);
+    }
+
+    psPin = &g_psBACONPins[ucId - 1];
+    if(psPin->ucFlags & BACON_PIN_OUTPUT)
+    {
+        return((g_pucBACONShadow[psPin->ucPort] & psPin->ucPin) ? 1 : 0);
+    }
+
+    return((g_ulBACONInputState >> (ucId - 1)) & 1);
+}
+
+//*****************************************************************************
+//
+// Read the current level of pin ucId, bypassing the input filter.
+//
+//*****************************************************************************
+unsigned long
+BACONPinReadRaw(unsigned char ucId)
+{
+    const tBACONPin *psPin;
+
+    if((ucId == 0) || (ucId > BACON_NUM_PINS))
+    {
+        return(0);
+    }
+
+    psPin = &g_psBACONPins[ucId - 1];
+    if(psPin->ucFlags & BACON_PIN_OUTPUT)
+    {
+        return((g_pucBACONShadow[psPin->ucPort] & psPin->ucPin) ? 1 : 0);
+    }
+
+    return(GPIOPinRead(g_pulBACONPortBase[psPin->ucPort], psPin->ucPin) ?
+           1 : 0);
+}
+
+//*****************************************************************************
+//
+// Drive output pin ucId to ulValue (zero or non-zero) right away.
+//
+//*****************************************************************************
+void
+BACONPinWrite(unsigned char ucId, unsigned long ulValue)
+{
+    const tBACONPin *psPin;
+    tBoolean bIntsOff;
+    unsigned char ucPort;
+
+    if((ucId == 0) || (ucId > BACON_NUM_PINS))
+    {
+        return;
+    }
+
+    psPin = &g_psBACONPins[ucId - 1];
+    if(!(psPin->ucFlags & BACON_PIN_OUTPUT))
+    {
+        return;
+    }
+
+    ucPort = psPin->ucPort;
+    bIntsOff = IntMasterDisable();
+    if(ulValue)
+    {
+        g_pucBACONShadow[ucPort] |= psPin->ucPin;
+    }
+    else
+    {
+        g_pucBACONShadow[ucPort] &= ~psPin->ucPin;
+    }
+    GPIOPinWrite(g_pulBACONPortBase[ucPort], psPin->ucPin,
+                 g_pucBACONShadow[ucPort]);
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+}
+
+//*****************************************************************************
+//
+// Return all BACON pins with the inputs filtered.  Pin id n is returned in
+// bit n - 1.  The outputs come from the shadow and the inputs from the filter,
+// so no port is read; this is called from the filter timer and on every GET.
+//
+//*****************************************************************************
+unsigned long
+BACONSnapshot(void)
+{
+    unsigned char pucShadow[BACON_NUM_PORTS];
+    const tBACONPin *psPin;
+    unsigned long ulBits;
+    tBoolean bIntsOff;
+    int i;
+
+    bIntsOff = IntMasterDisable();
+    for(i = 0; i < BACON_NUM_PORTS; i++)
+    {
+        pucShadow[i] = g_pucBACONShadow[i];
+    }
+    ulBits = g_ulBACONInputState;
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+
+    psPin = g_psBACONPins;
+    for(i = 0; i < BACON_NUM_PINS; i++, psPin++)
+    {
+        if((psPin->ucFlags & BACON_PIN_OUTPUT) &&
+           (pucShadow[psPin->ucPort] & psPin->ucPin))
+        {
+            ulBits |= 1 << i;
+        }
+    }
+
+    return(ulBits);
+}
+
+//*****************************************************************************
+//
+// Read all BACON pins at once, bypassing the input filter.  Each port with
+// inputs is read exactly once with interrupts masked, outputs come from the
+// shadow, and pin id n is returned in bit n - 1.
+//
+//*****************************************************************************
+unsigned long
+BACONRawSnapshot(void)
+{
+    unsigned char pucPort[BACON_NUM_PORTS];
+    const tBACONPin *psPin;
+    unsigned long ulBits;
+    tBoolean bIntsOff;
+    int i;
+
+    bIntsOff = IntMasterDisable();
+    for(i = 0; i < BACON_NUM_PORTS; i++)
+    {
+        pucPort[i] = g_pucBACONShadow[i];
+        if(g_pucBACONPortInputs[i])
+        {
+            pucPort[i] |= GPIOPinRead(g_pulBACONPortBase[i],
+                                      g_pucBACONPortInputs[i]);
+        }
+    }
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+
+    ulBits = 0;
+    psPin = g_psBACONPins;
+    for(i = 0; i < BACON_NUM_PINS; i++, psPin++)
+    {
+        if(pucPort[psPin->ucPort] & psPin->ucPin)
+        {
+            ulBits |= 1 << i;
+        }
+    }
+
+    return(ulBits);
+}
+
+//*****************************************************************************
+//
+// Return the pins that changed since the previous call, in the same layout
+// as BACONSnapshot().  Every call clears what it returns, whoever the caller
+// is, so two readers each only see the changes since either of them last
+// read.  The reference is seeded by BACONInit(), so the first call does not
+// report every pin that is high.
+//
+//*****************************************************************************
+unsigned long
+BACONChangedGet(void)
+{
+    unsigned long ulSnap, ulChanged;
+    tBoolean bIntsOff;
+
+    //
+    // The filter timer adds to the latch, so take it and clear it at once.
+    //
+    bIntsOff = IntMasterDisable();
+    ulSnap = BACONSnapshot();
+    ulChanged = (ulSnap ^ g_ulBACONChangedRef) | g_ulBACONChangedLatch;
+    g_ulBACONChangedRef = ulSnap;
+    g_ulBACONChangedLatch = 0;
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+
+    return(ulChanged);
+}
+
+//*****************************************************************************
+//
+// Return the enumerated baud rate currently selected by selector ulBaud.
+//
+//*****************************************************************************
+unsigned long
+BACONBaudGet(unsigned long ulBaud)
+{
+    unsigned long ulCode, ulRate;
+    int i;
+
+    if(ulBaud >= BACON_NUM_BAUD)
+    {
+        return(BACON_BAUD_OTHER);
+    }
+
+    ulCode = 0;
+    for(i = 0; i < 4; i++)
+    {
+        ulCode |= BACONPinRead(g_pucBACONBaudFirstId[ulBaud] + i) << i;
+    }
+
+    for(ulRate = BACON_BAUD_1200; ulRate <= BACON_BAUD_115200; ulRate++)
+    {
+        if(g_pucBACONBaudCode[ulRate - 1] == ulCode)
+        {
+            return(ulRate);
+        }
+    }
+
+    return(BACON_BAUD_OTHER);
+}
+
+//*****************************************************************************
+//
+// Check that ulRate is an enumerated baud rate that can be selected.  No rate
+// can be selected while the selector codes are unverified.
+//
+//*****************************************************************************
+int
+BACONBaudValid(unsigned long ulRate)
+{
+#if BACON_BAUD_WRITABLE
+    return((ulRate >= BACON_BAUD_1200) && (ulRate <= BACON_BAUD_115200));
+#else
+    return(0);
+#endif
+}
+
+//*****************************************************************************
+//
+// Stage the four pins of selector ulBaud for rate ulRate.  Selectors on a
+// single port are then committed in one masked write; BAUD1 spans ports B
+// and F and is committed as two back to back writes.
+//
+//*****************************************************************************
+void
+BACONBaudStage(unsigned long ulBaud, unsigned long ulRate)
+{
+    unsigned long ulCode;
+    int i;
+
+    if((ulBaud >= BACON_NUM_BAUD) || !BACONBaudValid(ulRate))
+    {
+        return;
+    }
+
+    ulCode = g_pucBACONBaudCode[ulRate - 1];
+    for(i = 0; i < 4; i++)
+    {
+        BACONSetStage(g_pucBACONBaudFirstId[ulBaud] + i, (ulCode >> i) & 1);
+    }
+}
+
+//*****************************************************************************
+//
+// Print the BACON I/O statistics on the console.
+//
+//*****************************************************************************
+void
+BACONStatsPrint(void)
+{
+    int i;
+
+    UARTprintf("set commits:%u aborts:%u port writes:%u\n",
+               g_ulBACONSetCommits, g_ulBACONSetAborts, g_ulBACONPortWrites);
+    PerfStatPrint("set-to-commit", &g_sBACONSetLatency);
+    UARTprintf("fiber edges:%u polled fixes:%u event overflows:%u\n",
+               g_ulBACONFiberEdges, g_ulBACONFiberPolled,
+               g_ulBACONEventOverflows);
+    PerfStatPrint("rx_los-to-fiber", &g_sBACONFiberLatency);
+    UARTprintf("inputs raw:%08x filtered:%08x\n", g_ulBACONRawState,
+               g_ulBACONInputState);
+    for(i = 0; i < BACON_NUM_MON; i++)
+    {
+        UARTprintf("mon%d edges:%u rate:%u/s saturated:%u\n", i + 1,
+                   g_pulBACONMonEdges[i], g_pulBACONMonRate[i],
+                   g_pulBACONMonSaturated[i]);
+    }
+}
@@ -0,0 +1,197 @@
+//*****************************************************************************
+//
+// bacon.h - BACON board I/O shared by the private MIB and the interrupt
+// handlers
+//
+//*****************************************************************************
+
+#ifndef __BACON_H__
+#define __BACON_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The number of BACON pins, numbered 1 to BACON_NUM_PINS exactly like the
+// sensor scalars in the private MIB, and the number of GPIO ports they
+// are spread over.
+//
+//*****************************************************************************
+#define BACON_NUM_PINS          32
+#define BACON_NUM_PORTS         6
+
+//*****************************************************************************
+//
+// Ids of the pins handled outside of the private MIB.
+//
+//*****************************************************************************
+#define BACON_ID_FIBER          1           // PE3, output
+#define BACON_ID_RX_LOS         2           // PB2, input
+#define BACON_ID_TP_LINK1       19          // PC7, input, TP_Link1
+#define BACON_ID_RXD1_MON       29          // PD6, input
+
+//*****************************************************************************
+//
+// The serial monitor lines with edge counters, RXD1_MON, TXD1_MON, RXD2_MON
+// and TXD2_MON, as lines 0 to 3.  Line n is pin id BACON_ID_RXD1_MON + n.
+//
+//*****************************************************************************
+#define BACON_NUM_MON           4
+
+//*****************************************************************************
+//
+// The links with flap statistics, TP_Link1-4, Far_TP_Link1-4 and RX_LOS, and
+// the statistics BACONLinkGet() returns.  The eight link pins are the ids
+// from BACON_ID_TP_LINK1 up.
+//
+//*****************************************************************************
+#define BACON_NUM_LINKS         9
+#define BACON_LINK_TRANSITIONS  1
+#define BACON_LINK_UP_TIME      2
+#define BACON_LINK_DOWN_TIME    3
+#define BACON_LINK_LAST_CHANGE  4
+
+//*****************************************************************************
+//
+// The four-pin baud rate selectors.  Pin _1 of a selector is bit 0 of its
+// code and pin _4 is bit 3.
+//
+//*****************************************************************************
+#define BACON_BAUD1             0           // BAUD1_1-BAUD1_4, PB0 PF1-PF3
+#define BACON_BAUD1_R           1           // BAUD1_1_R-BAUD1_4_R, PD3-PD0
+#define BACON_BAUD2             2           // BAUD2_1-BAUD2_4, PA7-PA4
+#define BACON_BAUD2_R           3           // BAUD2_1_R-BAUD2_4_R, PE4-PE7
+#define BACON_NUM_BAUD          4
+
+//*****************************************************************************
+//
+// The baud rate selectors can only be set once the selector codes in bacon.c
+// have been checked against the serial converter.  Until then the baudRate
+// objects are read-only and BACONBaudValid() accepts no rate.
+//
+//*****************************************************************************
+#ifndef BACON_BAUD_WRITABLE
+#define BACON_BAUD_WRITABLE     0
+#endif
+
+//*****************************************************************************
+//
+// Enumerated baud rates of the selectors.  BACON_BAUD_OTHER is returned when
+// the pins hold a code that has no enumeration.
+//
+//*****************************************************************************
+#define BACON_BAUD_OTHER        0
+#define BACON_BAUD_1200         1
+#define BACON_BAUD_2400         2
+#define BACON_BAUD_4800         3
+#define BACON_BAUD_9600         4
+#define BACON_BAUD_19200        5
+#define BACON_BAUD_38400        6
+#define BACON_BAUD_57600        7
+#define BACON_BAUD_115200       8
+
+//*****************************************************************************
+//
+// The largest input filter depth, in samples.
+//
+//*****************************************************************************
+#define BACON_FILTER_MAX_DEPTH  250
+
+//*****************************************************************************
+//
+// The number of filtered input changes kept in the history ring.  Must be a
+// power of two.
+//
+//*****************************************************************************
+#ifndef BACON_HISTORY_DEPTH
+#define BACON_HISTORY_DEPTH     64
+#endif
+#if (BACON_HISTORY_DEPTH & (BACON_HISTORY_DEPTH - 1)) != 0
+#error BACON_HISTORY_DEPTH must be a power of two!
+#endif
+
+//*****************************************************************************
+//
+// A history record: the sysUpTime of a filtered input change, all pins in
+// BACONSnapshot() layout after it, and the pins that changed.  ulSeq counts
+// from 1 and never repeats.
+//
+//*****************************************************************************
+typedef struct
+{
+    unsigned long ulSeq;
+    unsigned long ulUpTime;
+    unsigned long ulBits;
+    unsigned long ulChanged;
+}
+tBACONHistory;
+
+//*****************************************************************************
+//
+// A timestamped input edge captured in interrupt context.  ulCycles is the
+// cycle counter at the edge and ulUpTime the sysUpTime in 10 ms ticks.
+//
+//*****************************************************************************
+typedef struct
+{
+    unsigned long ulCycles;
+    unsigned long ulUpTime;
+    unsigned char ucId;
+    unsigned char ucLevel;
+}
+tBACONEvent;
+
+//*****************************************************************************
+//
+// Prototypes for the APIs.
+//
+//*****************************************************************************
+extern void BACONInit(void);
+extern void BACONSample(void);
+extern void BACONFilterLoad(void);
+extern unsigned long BACONFilterDepthGet(unsigned char ucId);
+extern void BACONFilterDepthSet(unsigned char ucId, unsigned long ulDepth);
+extern void BACONFilterIntHandler(void);
+extern void BACONMonIntHandler(void);
+extern unsigned long BACONMonEdgesGet(unsigned long ulLine);
+extern unsigned long BACONMonRateGet(unsigned long ulLine);
+extern unsigned long BACONMonSaturatedGet(unsigned long ulLine);
+extern unsigned long BACONLinkGet(unsigned char ucId, unsigned long ulWhich);
+extern int BACONHistoryGet(unsigned long ulSeq, tBACONHistory *psRec);
+extern int BACONHistoryTask(void);
+
+//*****************************************************************************
+//
+// Provided by the private MIB, which keeps the index of baconHistoryTable in
+// step with the history ring.
+//
+//*****************************************************************************
+extern void BACON_history_add(unsigned long ulSeq);
+extern void BACONRxLosIntHandler(void);
+extern int BACONEventGet(tBACONEvent *psEvent);
+extern long BACONFiberPoll(void);
+extern unsigned long BACONGenerationGet(void);
+extern unsigned long BACONLastChangeGet(void);
+extern void BACONSetBegin(void);
+extern void BACONSetStage(unsigned char ucId, unsigned long ulValue);
+extern void BACONSetCommit(void);
+extern void BACONSetAbort(void);
+extern unsigned long BACONPinRead(unsigned char ucId);
+extern unsigned long BACONPinReadRaw(unsigned char ucId);
+extern void BACONPinWrite(unsigned char ucId, unsigned long ulValue);
+extern unsigned long BACONSnapshot(void);
+extern unsigned long BACONRawSnapshot(void);
+extern unsigned long BACONChangedGet(void);
+extern unsigned long BACONBaudGet(unsigned long ulBaud);
+extern int BACONBaudValid(unsigned long ulRate);
+extern void BACONBaudStage(unsigned long ulBaud, unsigned long ulRate);
+extern void BACONStatsPrint(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BACON_H__
@@ -0,0 +1,452 @@
+//*****************************************************************************
+//
+// bench.c - on-target cycle benchmarks of the network data paths
+//
+// Each benchmark runs a data path routine on frames of typical sizes and
+// prints the fewest cycles it took, so that the cost of a change can be read
+// off the console.  They run from the console task, and interrupts taken
+// during a run only show up in the runs that are not the fastest.
+//
+//*****************************************************************************
+#include <stddef.h>
+#include <string.h>
+#include "hw_types.h"
+#include "uartstdio.h"
+#include "../lwip-1.3.0/src/include/lwip/opt.h"
+#include "../lwip-1.3.0/src/include/lwip/pbuf.h"
+#include "../lwip-1.3.0/src/include/lwip/netif.h"
+#include "../lwip-1.3.0/src/include/ipv4/lwip/inet.h"
+#include "../lwip-1.3.0/src/include/ipv4/lwip/inet_chksum.h"
+#include "../lwip-1.3.0/ports/stellaris/include/netif/stellarisif.h"
+#include "perfcnt.h"
+#include "bench.h"
+
+//*****************************************************************************
+//
+// The runs of each case, of which the fastest is reported.
+//
+//*****************************************************************************
+#define BENCH_RUNS              8
+
+//*****************************************************************************
+//
+// The transmitted frame sizes, without the FCS, and the headers in front of
+// the data: the length word, and the Ethernet, IP and TCP headers.  TCP data
+// is sent from where the application keeps it, which is why its alignment
+// varies.
+//
+//*****************************************************************************
+static const unsigned short g_pusBenchFrameSizes[] =
+{
+    60, 128, 256, 590, 1024, 1514
+};
+
+#define BENCH_NUM_SIZES         (sizeof(g_pusBenchFrameSizes) /               \
+                                 sizeof(g_pusBenchFrameSizes[0]))
+#define BENCH_TX_HDR_LEN        (2 + 14 + 20 + 20)
+
+//*****************************************************************************
+//
+// The length word and Ethernet header in front of a received IP packet.
+//
+//*****************************************************************************
+#define BENCH_RX_HDR_LEN        (2 + 14)
+
+//*****************************************************************************
+//
+// The data of the frames, and the register the copies write to in place of
+// the transmit fifo.
+//
+//*****************************************************************************
+static unsigned long g_pulBenchData[(1514 + 4) / 4];
+static volatile unsigned long g_ulBenchSink;
+
+//*****************************************************************************
+//
+// The transmit copy the driver used before stellarisif_tx_copy(), gathering
+// the bytes around every pbuf boundary one at a time, kept for comparison.
+//
+//*****************************************************************************
+static void
+BenchTxCopyGather(struct pbuf *p, volatile unsigned long *pulDst)
+{
+    struct pbuf *q;
+    unsigned char *pucBuf, *pucGather;
+    unsigned long *pulBuf;
+    unsigned long ulGather;
+    int iBuf, iGather;
+
+    iGather = 0;
+    pucGather = (unsigned char *)&ulGather;
+    ulGather = 0;
+
+    for(q = p; q != NULL; q = q->next)
+    {
+        pucBuf = (unsigned char *)q->payload;
+        iBuf = 0;
+
+        while((iBuf < q->len) && (iGather != 0))
+        {
+            pucGather[iGather] = pucBuf[iBuf++];
+            iGather = ((iGather + 1) % 4);
+        }
+        if((iGather == 0) && (iBuf != 0))
+        {
+            *pulDst = ulGather;
+            ulGather = 0;
+        }
+
+        pulBuf = (unsigned long *)&pucBuf[iBuf];
+        while((iBuf + 4) <= q->len)
+        {
+            *pulDst = *pulBuf++;
+            iBuf += 4;
+        }
+
+        while(iBuf < q->len)
+        {
+            pucGather[iGather] = pucBuf[iBuf++];
+            iGather = ((iGather + 1) % 4);
+        }
+    }
+
+    *pulDst = ulGather;
+}
+
+//*****************************************************************************
+//
+// Return the fewest cycles a transmit copy of frame p took.
+//
+//*****************************************************************************
+static unsigned long
+BenchTxCopyRun(void (*pfnCopy)(struct pbuf *p, volatile unsigned long *pulDst),
+               struct pbuf *p)
+{
+    unsigned long ulStart, ulCycles, ulMin;
+    int iRun;
+
+    ulMin = 0xFFFFFFFF;
+    for(iRun = 0; iRun < BENCH_RUNS; iRun++)
+    {
+        ulStart = PerfCountGet();
+        pfnCopy(p, &g_ulBenchSink);
+        ulCycles = PerfCountGet() - ulStart;
+        if(ulCycles < ulMin)
+        {
+            ulMin = ulCycles;
+        }
+    }
+
+    return(ulMin);
+}
+
+//*****************************************************************************
+//
+// Print the cycles the transmit copy takes for each frame size, with the TCP
+// data at each offset from a word boundary, next to those of the previous
+// copy.
+//
+//*****************************************************************************
+void
+BenchTxCopy(void)
+{
+    unsigned long pulNew[4], pulOld[4];
+    struct pbuf *psHdr, *psData;
+    unsigned long ulSize, ulOffset;
+
+    UARTprintf("tx copy cycles, data offset 0/1/2/3 (previous copy):\n");
+    for(ulSize = 0; ulSize < BENCH_NUM_SIZES; ulSize++)
+    {
+        for(ulOffset = 0; ulOffset < 4; ulOffset++)
+        {
+            psHdr = pbuf_alloc(PBUF_RAW, BENCH_TX_HDR_LEN, PBUF_RAM);
+            psData = pbuf_alloc(PBUF_RAW, 0, PBUF_REF);
+            if(!psHdr || !psData)
+            {
+                if(psHdr)
+                {
+                    pbuf_free(psHdr);
+                }
+                if(psData)
+                {
+                    pbuf_free(psData);
+                }
+                UARTprintf("out of pbufs\n");
+                return;
+            }
+
+            psData->payload = (unsigned char *)g_pulBenchData + ulOffset;
+            psData->len = psData->tot_len =
+                g_pusBenchFrameSizes[ulSize] - (BENCH_TX_HDR_LEN - 2);
+            pbuf_cat(psHdr, psData);
+
+            pulNew[ulOffset] = BenchTxCopyRun(stellarisif_tx_copy, psHdr);
+            pulOld[ulOffset] = BenchTxCopyRun(BenchTxCopyGather, psHdr);
+            pbuf_free(psHdr);
+        }
+
+        UARTprintf("%4u: %u/%u/%u/%u (%u/%u/%u/%u)\n",
+                   g_pusBenchFrameSizes[ulSize], pulNew[0], pulNew[1],
+                   pulNew[2], pulNew[3], pulOld[0], pulOld[1], pulOld[2],
+                   pulOld[3]);
+    }
+}
+
+//*****************************************************************************
+//
+// The checksum of lwIP's portable reference routine, LWIP_CHKSUM_ALGORITHM 1,
+// summing one byte pair at a time, kept to check and time the routine the
+// stack is built with against.
+//
+//*****************************************************************************
+static unsigned short
+BenchChksumRef(const void *pvData, unsigned long ulLen)
+{
+    const unsigned char *pucData;
+    unsigned long ulSum;
+
+    pucData = pvData;
+    ulSum = 0;
+    while(ulLen > 1)
+    {
+        ulSum += (pucData[0] << 8) | pucData[1];
+        pucData += 2;
+        ulLen -= 2;
+    }
+    if(ulLen)
+    {
+        ulSum += pucData[0] << 8;
+    }
+    ulSum = (ulSum >> 16) + (ulSum & 0xFFFF);
+    ulSum += ulSum >> 16;
+
+    return(htons((unsigned short)ulSum));
+}
+
+//*****************************************************************************
+//
+// Return the fewest cycles the checksum of ulLen bytes at pvData took, with
+// the stack's routine or with the reference one if bRef is set.  The result
+// of the last run is left in *pusSum.
+//
+//*****************************************************************************
+static unsigned long
+BenchChksumRun(const void *pvData, unsigned long ulLen, tBoolean bRef,
+               unsigned short *pusSum)
+{
+    unsigned long ulStart, ulCycles, ulMin;
+    int iRun;
+
+    ulMin = 0xFFFFFFFF;
+    for(iRun = 0; iRun < BENCH_RUNS; iRun++)
+    {
+        ulStart = PerfCountGet();
+        if(bRef)
+        {
+            *pusSum = BenchChksumRef(pvData, ulLen);
+        }
+        else
+        {
+            *pusSum = inet_chksum((void *)pvData, ulLen);
+        }
+        ulCycles = PerfCountGet() - ulStart;
+        if(ulCycles < ulMin)
+        {
+            ulMin = ulCycles;
+        }
+    }
+
+    return(ulMin);
+}
+
+//*****************************************************************************
+//
+// Return the fewest cycles the checksum of the pbuf chain p took.  The result
+// of the last run is left in *pusSum.
+//
+//*****************************************************************************
+static unsigned long
+BenchChksumPbufRun(struct pbuf *p, unsigned short *pusSum)
+{
+    unsigned long ulStart, ulCycles, ulMin;
+    int iRun;
+
+    ulMin = 0xFFFFFFFF;
+    for(iRun = 0; iRun < BENCH_RUNS; iRun++)
+    {
+        ulStart = PerfCountGet();
+        *pusSum = inet_chksum_pbuf(p);
+        ulCycles = PerfCountGet() - ulStart;
+        if(ulCycles < ulMin)
+        {
+            ulMin = ulCycles;
+        }
+    }
+
+    return(ulMin);
+}
+
+//*****************************************************************************
+//
+// Print the cycles the Internet checksum takes over each IP packet size, with
+// the data at each offset from a word boundary and as a chain of pool pbufs,
+// next to those of the reference routine.  A result that differs from the
+// reference is reported.
+//
+//*****************************************************************************
+void
+BenchChksum(void)
+{
+    unsigned long pulNew[4], pulRef[4];
+    unsigned short usSum, usRef;
+    unsigned long ulSize, ulOffset, ulLen, ulNew;
+    unsigned char *pucData;
+    struct pbuf *p, *q;
+    int iBad;
+
+    //
+    // Fill the data with a pattern that exercises the carries.
+    //
+    pucData = (unsigned char *)g_pulBenchData;
+    for(ulLen = 0; ulLen < sizeof(g_pulBenchData); ulLen++)
+    {
+        pucData[ulLen] = (unsigned char)(0xF7 - (ulLen * 13));
+    }
+
+    iBad = 0;
+    UARTprintf("checksum cycles, data offset 0/1/2/3 (reference):\n");
+    for(ulSize = 0; ulSize < BENCH_NUM_SIZES; ulSize++)
+    {
+        ulLen = g_pusBenchFrameSizes[ulSize] - 14;
+        for(ulOffset = 0; ulOffset < 4; ulOffset++)
+        {
+            pulNew[ulOffset] = BenchChksumRun(pucData + ulOffset, ulLen,
+                                              false, &usSum);
+            pulRef[ulOffset] = BenchChksumRun(pucData + ulOffset, ulLen,
+                                              true, &usRef);
+            if(usSum != (unsigned short)~usRef)
+            {
+                iBad++;
+            }
+        }
+
+        UARTprintf("%4u: %u/%u/%u/%u (%u/%u/%u/%u)\n", ulLen, pulNew[0],
+                   pulNew[1], pulNew[2], pulNew[3], pulRef[0], pulRef[1],
+                   pulRef[2], pulRef[3]);
+    }
+
+    UARTprintf("checksum cycles, pool pbuf chain:\n");
+    for(ulSize = 0; ulSize < BENCH_NUM_SIZES; ulSize++)
+    {
+        ulLen = g_pusBenchFrameSizes[ulSize] - 14;
+        p = pbuf_alloc(PBUF_RAW, ulLen, PBUF_POOL);
+        if(!p)
+        {
+            UARTprintf("out of pbufs\n");
+            break;
+        }
+        for(q = p, ulOffset = 0; q != NULL; q = q->next)
+        {
+            memcpy(q->payload, pucData + ulOffset, q->len);
+            ulOffset += q->len;
+        }
+
+        ulNew = BenchChksumPbufRun(p, &usSum);
+        if(usSum != (unsigned short)~BenchChksumRef(pucData, ulLen))
+        {
+            iBad++;
+        }
+        UARTprintf("%4u: pbufs:%u cycles:%u\n", ulLen, pbuf_clen(p), ulNew);
+        pbuf_free(p);
+    }
+
+    if(iBad)
+    {
+        UARTprintf("%u checksums differ from the reference\n", iBad);
+    }
+}
+
+#if PBUF_POOL_LARGE_SIZE
+//*****************************************************************************
+//
+// Return the fewest cycles the IP checksum of received frame p took, or its
+// copy to a flat buffer if bCopy is set.
+//
+//*****************************************************************************
+static unsigned long
+BenchRxRun(struct pbuf *p, tBoolean bCopy)
+{
+    unsigned long ulStart, ulCycles, ulMin;
+    int iRun;
+
+    pbuf_header(p, -BENCH_RX_HDR_LEN);
+    ulMin = 0xFFFFFFFF;
+    for(iRun = 0; iRun < BENCH_RUNS; iRun++)
+    {
+        ulStart = PerfCountGet();
+        if(bCopy)
+        {
+            pbuf_copy_partial(p, g_pulBenchData, p->tot_len, 0);
+        }
+        else
+        {
+            g_ulBenchSink = inet_chksum_pbuf(p);
+        }
+        ulCycles = PerfCountGet() - ulStart;
+        if(ulCycles < ulMin)
+        {
+            ulMin = ulCycles;
+        }
+    }
+    pbuf_header(p, BENCH_RX_HDR_LEN);
+
+    return(ulMin);
+}
+
+//*****************************************************************************
+//
+// Print the cycles the IP checksum and a copy of a received frame take when
+// it is a chain of pool pbufs and when it is one large pbuf, for the frame
+// sizes that do not fit in one pool pbuf.
+//
+//*****************************************************************************
+void
+BenchRxChain(void)
+{
+    struct pbuf *psChain, *psLarge;
+    unsigned long ulSize, ulLen;
+
+    UARTprintf("rx cycles, chained/large pbuf:\n");
+    for(ulSize = 0; ulSize < BENCH_NUM_SIZES; ulSize++)
+    {
+        ulLen = g_pusBenchFrameSizes[ulSize] + 2;
+        if(ulLen <= PBUF_POOL_BUFSIZE)
+        {
+            continue;
+        }
+
+        psChain = pbuf_alloc(PBUF_RAW, ulLen, PBUF_POOL);
+        psLarge = pbuf_alloc_large(ulLen);
+        if(!psChain || !psLarge)
+        {
+            if(psChain)
+            {
+                pbuf_free(psChain);
+            }
+            if(psLarge)
+            {
+                pbuf_free(psLarge);
+            }
+            UARTprintf("out of pbufs\n");
+            return;
+        }
+
+        UARTprintf("%4u: pbufs:%u checksum:%u/%u copy:%u/%u\n",
+                   g_pusBenchFrameSizes[ulSize], pbuf_clen(psChain),
+                   BenchRxRun(psChain, false), BenchRxRun(psLarge, false),
+                   BenchRxRun(psChain, true), BenchRxRun(psLarge, true));
+        pbuf_free(psChain);
+        pbuf_free(psLarge);
+    }
+}
+#endif
@@ -0,0 +1,28 @@
+//*****************************************************************************
+//
+// bench.h - on-target cycle benchmarks of the network data paths
+//
+//*****************************************************************************
+
+#ifndef __BENCH_H__
+#define __BENCH_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// Prototypes for the APIs.
+//
+//*****************************************************************************
+extern void BenchTxCopy(void);
+extern void BenchRxChain(void);
+extern void BenchChksum(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __BENCH_H__
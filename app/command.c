@@ -11,9 +11,16 @@
 #include <stdio.h>
 #include "softeeprom_wrapper.h"
 #include "storage_config.h"
+#include "bacon.h"
+#include "alarm.h"
+#include "telemetry.h"
+#include "log.h"
+#include "sched.h"
+#include "bench.h"
 
 #define MAXARGS	6
 #define MAXARGLEN 31
+#define MAXCMDLEN 128
 
 extern void DisplayIPAddress(unsigned long ipaddr, char *type);
 
@@ -146,6 +153,131 @@ int getMacAddr(int nargs, char **args)
 	return 0;
 }
 
+int showBacon(int nargs, char **args)
+{
+	BACONStatsPrint();
+	
+	return 0;
+}
+
+int showAlarm(int nargs, char **args)
+{
+	AlarmPrint();
+	
+	return 0;
+}
+
+int setTrapDest(int nargs, char **args)
+{
+	int ret;
+	int ulIPAddress[4];
+	
+	if (nargs != 2)
+	{
+		UARTprintf("Usage:settrap ip\n");
+		return 0;
+	}
+	
+	ret = sscanf(args[1], "%d.%d.%d.%d", ulIPAddress, ulIPAddress + 1,
+			ulIPAddress + 2, ulIPAddress + 3);
+	if (ret == 4)
+	{
+		// saved to eeprom, takes effect at once
+		AlarmTrapDestSet(ulIPAddress[0] << 24 | ulIPAddress[1] << 16 |
+				ulIPAddress[2] << 8 | ulIPAddress[3]);
+	}
+	else
+	{
+		UARTprintf("Usage:settrap ip\n");
+	}
+	
+	return 0;
+}
+
+int telemetry(int nargs, char **args)
+{
+	int ret;
+	int ulIPAddress[4];
+	int ulPort, ulInterval;
+	
+	if (nargs == 1)
+	{
+		TelemetryPrint();
+		return 0;
+	}
+	
+	if (nargs != 4)
+	{
+		UARTprintf("Usage:telemetry [ip port interval]\n");
+		return 0;
+	}
+	
+	ret = sscanf(args[1], "%d.%d.%d.%d", ulIPAddress, ulIPAddress + 1,
+			ulIPAddress + 2, ulIPAddress + 3);
+	ret += sscanf(args[2], "%d", &ulPort);
+	ret += sscanf(args[3], "%d", &ulInterval);
+	if (ret == 6 && ulInterval >= 0 && TelemetryValid(TELEMETRY_PORT, ulPort) &&
+		TelemetryValid(TELEMETRY_INTERVAL, ulInterval))
+	{
+		// saved to eeprom, takes effect at once
+		TelemetrySet(TELEMETRY_PORT, ulPort);
+		TelemetrySet(TELEMETRY_INTERVAL, ulInterval);
+		TelemetrySet(TELEMETRY_COLLECTOR, ulIPAddress[0] << 24 |
+				ulIPAddress[1] << 16 | ulIPAddress[2] << 8 | ulIPAddress[3]);
+	}
+	else
+	{
+		UARTprintf("Usage:telemetry [ip port interval]\n");
+	}
+	
+	return 0;
+}
+
+int showLog(int nargs, char **args)
+{
+	LogStatsPrint();
+	
+	return 0;
+}
+
+int showSched(int nargs, char **args)
+{
+	SchedStatsPrint();
+	
+	return 0;
+}
+
+int showNet(int nargs, char **args)
+{
+	lwIPStatsPrint();
+	
+	return 0;
+}
+
+int bench(int nargs, char **args)
+{
+	if (nargs == 2 && !strcmp(args[1], "tx"))
+	{
+		BenchTxCopy();
+	}
+#if PBUF_POOL_LARGE_SIZE
+	else if (nargs == 2 && !strcmp(args[1], "rx"))
+	{
+		BenchRxChain();
+	}
+#endif
+	else if (nargs == 2 && !strcmp(args[1], "chksum"))
+	{
+		BenchChksum();
+	}
+	else
+	{
+		UARTprintf("Usage:bench tx|rx|chksum\n");
+	}
+	
+	return 0;
+}
+
 static const struct command cmd_tbl[] = 
 {
 	{"reset", 		systemReset, "Reset the system"},
@@ -154,6 +286,14 @@ static const struct command cmd_tbl[] =
 	{"setip",	setIpAddr, 	"Set the ip address, netmask and gateway"},
 	{"getmac",	getMacAddr, "Get the MAC address"},
 	{"setmac",  setMacAddr, "Set the MAC address"},
+	{"bacon",	showBacon,	"Show the BACON I/O statistics"},
+	{"alarm",	showAlarm,	"Show the alarm rows and trap destination"},
+	{"settrap",	setTrapDest,	"Set the trap destination, 0.0.0.0 for none"},
+	{"log",		showLog,	"Show the deferred log counters"},
+	{"sched",	showSched,	"Show the main loop task statistics"},
+	{"net",		showNet,	"Show the Ethernet interface statistics"},
+	{"bench",	bench,		"Run a data path benchmark: tx, rx, chksum"},
+	{"telemetry",	telemetry,	"Show or set the telemetry collector, port and interval"},
 };
 
 int help(int nargs, char **args)
@@ -193,6 +333,9 @@ textresume:
 	}
 	
 text:
+	// the words after MAXARGS and the characters after MAXARGLEN are dropped
+	if (nargs == MAXARGS)
+		goto textdone;
 	s = args[nargs];
 	for(;;)
 	{
@@ -211,7 +354,9 @@ text:
 				cmd++;
 				break;
 			default:
-				*s++ = *cmd++;
+				if (s < &args[nargs][MAXARGLEN - 1])
+					*s++ = *cmd;
+				cmd++;
 				break;
 		}
 	}
@@ -240,3 +385,24 @@ textdone:
 
 	UARTprintf("lwip:");
 }
+
+// The console task.  Run the command line waiting in the UART receive
+// buffer, if a whole one has arrived, and return at once otherwise.  The UART
+// interrupt handler echoes the characters and handles backspace as they are
+// typed.
+int pollCmd(void)
+{
+	char cmd[MAXCMDLEN];
+	unsigned long cmdlen;
+	
+	// a full receive buffer is taken as a line, the UART interrupt handler
+	// drops characters once it is full so no line end would ever come
+	if (UARTPeek('\r') < 0 && UARTPeek('\n') < 0 && UARTPeek(0x1b) < 0 &&
+		UARTRxBytesAvail() < UART_RX_BUFFER_SIZE - 1)
+		return 0;
+	
+	cmdlen = UARTgets(cmd, sizeof(cmd));
+	parseCmd(cmd, cmdlen);
+	
+	return 0;
+}
@@ -44,6 +44,12 @@
 #include "softeeprom.h"
 #include "softeeprom_wrapper.h"
 #include "storage_config.h"
+#include "perfcnt.h"
+#include "bacon.h"
+#include "alarm.h"
+#include "telemetry.h"
+#include "log.h"
+#include "sched.h"
 
 //*****************************************************************************
 //
@@ -115,7 +121,7 @@
 // External Application references.
 //
 //*****************************************************************************
-extern void parseCmd(char *cmd, unsigned long len);
+extern int pollCmd(void);
 
 //*****************************************************************************
 //
@@ -188,7 +194,7 @@ lwIPHostTimerHandler(void)
 void
 SysTickIntHandler(void)
 {
-    unsigned char rx_los, fiber;
+    long rx_los;
     
     //
     // Call the lwIP timer handler.
@@ -199,14 +205,23 @@ SysTickIntHandler(void)
 	// update SNMP uptime timestamp
 	//
 	snmp_inc_sysuptime();
+	
+	//
+	// look for BACON input changes
+	//
+	BACONSample();
     
-    // The FIBER pin keep track with RX_LOS
-    rx_los = GPIOPinRead(GPIO_PORTB_BASE, GPIO_PIN_2) >> 2;
-    fiber = GPIOPinRead(GPIO_PORTE_BASE, GPIO_PIN_3) >> 3;
-    if (rx_los != fiber) {
-        UARTprintf("Write fiber pin to %d\n", rx_los);
-        GPIOPinWrite(GPIO_PORTE_BASE, GPIO_PIN_3, rx_los << 3);
+    // The FIBER pin keep track with RX_LOS.  The GPIO port B interrupt does
+    // this on every edge, this only catches what it missed.
+    rx_los = BACONFiberPoll();
+    if (rx_los >= 0) {
+        LogPrintf("Write fiber pin to %d\n", rx_los);
     }
+
+    //
+    // Look for console input.
+    //
+    SchedPost(SCHED_TASK_CONSOLE);
 }
 
 
@@ -219,8 +234,6 @@ int
 main(void)
 {
     unsigned char pucMACArray[6];
-	char cmd[128];
-	unsigned long cmdlen = 0;
 	unsigned long ulIpAddr, ulNetMask, ulGateWay;
    
     //
@@ -229,6 +242,11 @@ main(void)
     SysCtlClockSet(SYSCTL_SYSDIV_16 | SYSCTL_USE_PLL | SYSCTL_OSC_MAIN |
                    SYSCTL_XTAL_6MHZ);
 
+    //
+    // Start the cycle counter used for latency measurements.
+    //
+    PerfCountInit();
+
     //
     // Initialize the UART for debug output.
     //
@@ -306,6 +324,11 @@ main(void)
                    GPIO_DIR_MODE_OUT);
     GPIOPadConfigSet(GPIO_PORTF_BASE, GPIO_PIN_1 | GPIO_PIN_2 | GPIO_PIN_3, 
                      GPIO_STRENGTH_2MA, GPIO_PIN_TYPE_STD);
+
+    //
+    // Take the initial BACON input state.
+    //
+    BACONInit();
 /*
     //
     // Enable Port F for Ethernet LEDs.
@@ -343,6 +366,21 @@ main(void)
     SysTickEnable();
     SysTickIntEnable();
 
+    //
+    // RX_LOS edges, and then the serial monitor edges, must be able to
+    // preempt the Ethernet, filter and SysTick handlers.  The console only
+    // moves characters between the UART and its buffers, so it runs below all
+    // of them.  Only the top three priority bits are implemented, so the
+    // levels are 0x20 apart; 0x10 would be the same level as 0x00 and the
+    // serial monitor edges could then hold off an RX_LOS edge.
+    //
+    IntPrioritySet(INT_GPIOB, 0x00);
+    IntPrioritySet(INT_GPIOD, 0x20);
+    IntPrioritySet(INT_ETH, 0x40);
+    IntPrioritySet(INT_TIMER0A, 0x40);
+    IntPrioritySet(FAULT_SYSTICK, 0x40);
+    IntPrioritySet(INT_UART0, 0x60);
+
     //
     // Enable processor interrupts.
     //
@@ -385,22 +423,37 @@ main(void)
 	if (ulGateWay == 0xFFFFFFFF)
 		ulGateWay = 0;
 	
+	// get the BACON input filter depths
+	BACONFilterLoad();
+
     //
     // Initialze the lwIP library, using DHCP.
     //
     lwIPInit(pucMACArray, ulIpAddr, ulNetMask, ulGateWay, IPADDR_USE_STATIC);
 
+	// load the alarm rows and the trap destination
+	AlarmInit();
+
+	// load the telemetry collector and allocate the report buffer
+	TelemetryInit();
+
     //
     // Indicate that DHCP has started.
     //
 	UARTprintf("Waiting for IP...\n");
 
     //
-    // Loop forever.  All the work is done in interrupt handlers.
+    // Loop forever.  The interrupt handlers only move data and post tasks;
+    // lwIP, the deferred log and the console all run here, one task at a
+    // time.  The budgets are in microseconds.
     //
+    SchedTaskSet(SCHED_TASK_LWIP_INPUT, "lwip input", lwIPInputTask, 2000);
+    SchedTaskSet(SCHED_TASK_LWIP_TIMER, "lwip timer", lwIPTimerTask, 2000);
+    SchedTaskSet(SCHED_TASK_BACON, "bacon", BACONHistoryTask, 200);
+    SchedTaskSet(SCHED_TASK_LOG, "log", LogDrain, 500);
+    SchedTaskSet(SCHED_TASK_CONSOLE, "console", pollCmd, 5000);
     while(1)
     {
-		cmdlen = UARTgets(cmd, sizeof(cmd));
-		parseCmd(cmd, cmdlen);
+		SchedRun();
     }
 }
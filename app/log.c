@@ -0,0 +1,176 @@
+//*****************************************************************************
+//
+// log.c - deferred console messages from interrupt context
+//
+// UARTprintf() waits for the UART to take every character, which is over a
+// millisecond per line at 115200 baud and stalls whatever interrupt handler
+// called it.  LogPrintf() only records the format, the arguments and the time
+// in a ring, and LogDrain() formats them later from the main loop.
+//
+//*****************************************************************************
+#include <stdarg.h>
+#include "hw_types.h"
+#include "interrupt.h"
+#include "uartstdio.h"
+#include "../lwip-1.3.0/src/include/lwip/opt.h"
+#include "../lwip-1.3.0/src/include/lwip/snmp.h"
+#include "sched.h"
+#include "log.h"
+
+//*****************************************************************************
+//
+// A logged message.  The format and any %s arguments are kept as pointers,
+// so they must be string constants.
+//
+//*****************************************************************************
+typedef struct
+{
+    const char *pcFormat;
+    unsigned long ulUpTime;
+    unsigned long pulArgs[LOG_MAX_ARGS];
+}
+tLogEntry;
+
+//*****************************************************************************
+//
+// The ring.  g_ulLogWrite is only changed by LogPrintf() with interrupts
+// disabled, since handlers at every priority may log, and g_ulLogRead only by
+// LogDrain().  Both count messages and are masked when used as indexes.
+//
+//*****************************************************************************
+static tLogEntry g_psLogRing[LOG_RING_SIZE];
+static volatile unsigned long g_ulLogWrite;
+static volatile unsigned long g_ulLogRead;
+
+//*****************************************************************************
+//
+// The messages dropped because the ring was full, and how many of those
+// LogDrain() has already reported.
+//
+//*****************************************************************************
+static volatile unsigned long g_ulLogLost;
+static unsigned long g_ulLogLostReported;
+
+//*****************************************************************************
+//
+// The UART transmit buffer space LogDrain() wants before it prints a message,
+// so that the end of a message is not discarded by a full buffer.
+//
+//*****************************************************************************
+#define LOG_LINE_LEN            96
+
+//*****************************************************************************
+//
+// Record a message to be printed by LogDrain().  It takes the same formats as
+// UARTprintf(), with at most LOG_MAX_ARGS arguments.  Safe to call from any
+// interrupt handler.
+//
+//*****************************************************************************
+void
+LogPrintf(const char *pcFormat, ...)
+{
+    unsigned long pulArgs[LOG_MAX_ARGS];
+    unsigned long ulUpTime, ulArgs, ulIdx;
+    const char *pcChar;
+    tLogEntry *psEntry;
+    tBoolean bIntsOff;
+    va_list vaArgP;
+
+    //
+    // Fetch one argument for every conversion in the format.
+    //
+    va_start(vaArgP, pcFormat);
+    for(ulArgs = 0, pcChar = pcFormat; *pcChar && (ulArgs < LOG_MAX_ARGS);
+        pcChar++)
+    {
+        if(*pcChar == '%')
+        {
+            if(pcChar[1] == '%')
+            {
+                pcChar++;
+            }
+            else
+            {
+                pulArgs[ulArgs++] = va_arg(vaArgP, unsigned long);
+            }
+        }
+    }
+    va_end(vaArgP);
+
+    snmp_get_sysuptime(&ulUpTime);
+
+    bIntsOff = IntMasterDisable();
+    if((g_ulLogWrite - g_ulLogRead) >= LOG_RING_SIZE)
+    {
+        g_ulLogLost++;
+    }
+    else
+    {
+        psEntry = &g_psLogRing[g_ulLogWrite & (LOG_RING_SIZE - 1)];
+        psEntry->pcFormat = pcFormat;
+        psEntry->ulUpTime = ulUpTime;
+        for(ulIdx = 0; ulIdx < ulArgs; ulIdx++)
+        {
+            psEntry->pulArgs[ulIdx] = pulArgs[ulIdx];
+        }
+        g_ulLogWrite++;
+    }
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+
+    SchedPost(SCHED_TASK_LOG);
+}
+
+//*****************************************************************************
+//
+// Print the logged messages, each after its sysUpTime in seconds, as far as
+// the UART transmit buffer has room.  This is the log task; it returns
+// non-zero if messages are left.
+//
+//*****************************************************************************
+int
+LogDrain(void)
+{
+    tLogEntry *psEntry;
+    unsigned long ulLost;
+
+    while(g_ulLogRead != g_ulLogWrite)
+    {
+#ifdef UART_BUFFERED
+        if(UARTTxBytesFree() < LOG_LINE_LEN)
+        {
+            return(1);
+        }
+#endif
+        psEntry = &g_psLogRing[g_ulLogRead & (LOG_RING_SIZE - 1)];
+        UARTprintf("[%u.%02u] ", psEntry->ulUpTime / 100,
+                   psEntry->ulUpTime % 100);
+        UARTprintf(psEntry->pcFormat, psEntry->pulArgs[0],
+                   psEntry->pulArgs[1], psEntry->pulArgs[2],
+                   psEntry->pulArgs[3]);
+        g_ulLogRead++;
+    }
+
+    ulLost = g_ulLogLost;
+    if(ulLost != g_ulLogLostReported)
+    {
+        UARTprintf("%u log messages lost\n", ulLost - g_ulLogLostReported);
+        g_ulLogLostReported = ulLost;
+    }
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Print the log ring counters on the console.
+//
+//*****************************************************************************
+void
+LogStatsPrint(void)
+{
+    UARTprintf("log messages:%u pending:%u lost:%u\n", g_ulLogWrite,
+               g_ulLogWrite - g_ulLogRead, g_ulLogLost);
+}
@@ -0,0 +1,40 @@
+//*****************************************************************************
+//
+// log.h - deferred console messages from interrupt context
+//
+//*****************************************************************************
+
+#ifndef __LOG_H__
+#define __LOG_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The number of messages the ring holds, a power of two, and the most
+// arguments a message can have.
+//
+//*****************************************************************************
+#define LOG_RING_SIZE           32
+#if (LOG_RING_SIZE & (LOG_RING_SIZE - 1)) != 0
+#error LOG_RING_SIZE must be a power of two!
+#endif
+#define LOG_MAX_ARGS            4
+
+//*****************************************************************************
+//
+// Prototypes for the APIs.
+//
+//*****************************************************************************
+extern void LogPrintf(const char *pcFormat, ...);
+extern int LogDrain(void);
+extern void LogStatsPrint(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __LOG_H__
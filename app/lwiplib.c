@@ -151,6 +151,30 @@
 extern void lwIPHostTimerHandler(void);
 #endif
 
+//*****************************************************************************
+//
+// The interval, in ms, at which the SNMP alarm rows are checked.  Defined to
+// 0 (the default value) when there is no alarm engine.
+//
+//*****************************************************************************
+#ifndef ALARM_TMR_INTERVAL
+#define ALARM_TMR_INTERVAL      0
+#else
+extern void AlarmTimerHandler(void);
+#endif
+
+//*****************************************************************************
+//
+// The interval, in ms, at which the telemetry push is checked for a report to
+// send.  Defined to 0 (the default value) when there is no telemetry push.
+//
+//*****************************************************************************
+#ifndef TELEMETRY_TMR_INTERVAL
+#define TELEMETRY_TMR_INTERVAL  0
+#else
+extern void TelemetryTimerHandler(void);
+#endif
+
 //*****************************************************************************
 //
 // Driverlib headers needed for this library module.
@@ -165,6 +189,9 @@ extern void lwIPHostTimerHandler(void);
 #include "../inc/gpio.h"
 #include "../inc/sysctl.h"
 #include "../inc/debug.h"
+#include "uartstdio.h"
+#include "perfcnt.h"
+#include "sched.h"
 
 //*****************************************************************************
 //
@@ -173,6 +200,13 @@ extern void lwIPHostTimerHandler(void);
 //*****************************************************************************
 static struct netif lwip_netif;
 
+//*****************************************************************************
+//
+// The time spent in each run of the Ethernet interrupt handler.
+//
+//*****************************************************************************
+static tPerfStat g_sEthIntTime;
+
 //*****************************************************************************
 //
 // The local time for the lwIP Library Abstraction layer, used to support the
@@ -197,6 +231,24 @@ static unsigned long g_ulTCPTimer = 0;
 static unsigned long g_ulHostTimer = 0;
 #endif
 
+//*****************************************************************************
+//
+// The local time when the alarm timer was last serviced.
+//
+//*****************************************************************************
+#if ALARM_TMR_INTERVAL
+static unsigned long g_ulAlarmTimer = 0;
+#endif
+
+//*****************************************************************************
+//
+// The local time when the telemetry timer was last serviced.
+//
+//*****************************************************************************
+#if TELEMETRY_TMR_INTERVAL
+static unsigned long g_ulTelemetryTimer = 0;
+#endif
+
 //*****************************************************************************
 //
 // The local time when the ARP timer was last serviced.
@@ -248,8 +300,8 @@ static unsigned long g_ulIPMode = IPADDR_USE_STATIC;
 //!
 //! This function services all of the lwIP periodic timers, including TCP and
 //! Host timers.  This should be called from the lwIP context, which may be
-//! the Ethernet interrupt (in the case of a non-RTOS system) or the lwIP
-//! thread, in the event that an RTOS is used.
+//! the timer task of the main loop (in the case of a non-RTOS system) or the
+//! lwIP thread, in the event that an RTOS is used.
 //!
 //! \return None.
 //
@@ -268,6 +320,28 @@ lwIPServiceTimers(void)
     }
 #endif
 
+    //
+    // Service the alarm timer.
+    //
+#if ALARM_TMR_INTERVAL
+    if((g_ulLocalTimer - g_ulAlarmTimer) >= ALARM_TMR_INTERVAL)
+    {
+        g_ulAlarmTimer = g_ulLocalTimer;
+        AlarmTimerHandler();
+    }
+#endif
+
+    //
+    // Service the telemetry timer.
+    //
+#if TELEMETRY_TMR_INTERVAL
+    if((g_ulLocalTimer - g_ulTelemetryTimer) >= TELEMETRY_TMR_INTERVAL)
+    {
+        g_ulTelemetryTimer = g_ulLocalTimer;
+        TelemetryTimerHandler();
+    }
+#endif
+
     //
     // Service the ARP timer.
     //
@@ -371,6 +445,7 @@ lwIPInit(const unsigned char *pucMAC, unsigned long ulIPAddr,
     // Enable the ethernet peripheral.
     //
     SysCtlPeripheralEnable(SYSCTL_PERIPH_ETH);
+    PerfStatReset(&g_sEthIntTime);
 
     //
     // Program the MAC address into the Ethernet controller.
@@ -461,17 +536,29 @@ lwIPTimer(unsigned long ulTimeMS)
     //
     g_ulLocalTimer += ulTimeMS;
 
+    //
+    // Advance the clock of the driver's ARP rate limits.
+    //
+    stellarisif_timer(&lwip_netif, ulTimeMS);
+
 #if NO_SYS
     //
-    // Generate an Ethernet interrupt.  This will perform the actual work
-    // of checking the lwIP timers and taking the appropriate actions.  This is
-    // needed since lwIP is not re-entrant, and this allows all lwIP calls to
-    // be placed inside the Ethernet interrupt handler ensuring that all calls
-    // into lwIP are coming from the same context, preventing any reentrancy
-    // issues.  Putting all the lwIP calls in the Ethernet interrupt handler
-    // avoids the use of mutexes to avoid re-entering lwIP.
+    // Post the timer task.  This will perform the actual work of checking the
+    // lwIP timers and taking the appropriate actions.  lwIP is not
+    // re-entrant, so all calls into lwIP are made from the tasks the main
+    // loop runs, which never preempt each other.
     //
-    HWREG(NVIC_SW_TRIG) |= INT_ETH - 16;
+    SchedPost(SCHED_TASK_LWIP_TIMER);
+
+    //
+    // While the receive interrupt is masked the receive fifo is only read by
+    // the input task, which waits for this tick between polls so that the
+    // lower priority tasks still run during a packet storm.
+    //
+    if(stellarisif_polling(&lwip_netif))
+    {
+        SchedPost(SCHED_TASK_LWIP_INPUT);
+    }
 
 #else
     //
@@ -503,7 +590,9 @@ lwIPTimer(unsigned long ulTimeMS)
 void
 lwIPEthernetIntHandler(void)
 {
-    unsigned long ulStatus;
+    unsigned long ulStatus, ulStart;
+
+    ulStart = PerfCountGet();
 
     //
     // Read and Clear the interrupt.
@@ -513,28 +602,126 @@ lwIPEthernetIntHandler(void)
 
     //
     // If a transmit/rx interrupt was active, run the low-level interrupt
-    // handler.
+    // handler.  It only moves up to STELLARIS_RX_BUDGET received packets to
+    // the receive queue, and leaves the rest of a burst to be polled by the
+    // input task; the packets are processed, and the next one transmitted,
+    // by the input task.
     //
     if(ulStatus)
     {
         stellarisif_interrupt(&lwip_netif);
+        SchedPost(SCHED_TASK_LWIP_INPUT);
     }
 
-#if NO_SYS
-    //
-    // If no RTOS is enabled, then we do all lwIP procesing in the interrupt.
-    //
+    PerfStatUpdate(&g_sEthIntTime, PerfCountGet() - ulStart);
+}
 
-    //
-    // Service any packets on the receive queue.
-    //
-    stellarisif_input(&lwip_netif);
+//*****************************************************************************
+//
+// The input task.  Reads the receive fifo while its interrupt is masked and
+// processes the received packets, until both are empty or the task budget is
+// spent, and starts the transmission of the next queued packet.  Returns
+// non-zero if packets may be left in the receive queue; a fifo still being
+// polled is picked up again by lwIPTimer().
+//
+//*****************************************************************************
+int
+lwIPInputTask(void)
+{
+    int iMore, iPolling;
+
+    stellarisif_transmit(&lwip_netif);
+
+    do
+    {
+        iPolling = stellarisif_poll(&lwip_netif, 1);
+        iMore = stellarisif_input(&lwip_netif, 1);
+
+        //
+        // Keep the transmitter busy, so that the replies to a burst of
+        // requests do not pile up on the transmit queue.
+        //
+        stellarisif_transmit(&lwip_netif);
+    }
+    while((iMore || iPolling) && SchedTimeLeft());
 
+    return(iMore && !iPolling);
+}
+
+//*****************************************************************************
+//
+// The timer task, posted by lwIPTimer().
+//
+//*****************************************************************************
+int
+lwIPTimerTask(void)
+{
+    lwIPServiceTimers();
+
+    return(0);
+}
+
+//*****************************************************************************
+//
+// Print the statistics of the Ethernet interface on the console.
+//
+//*****************************************************************************
+void
+lwIPStatsPrint(void)
+{
+    struct stellarisif_stats sStats;
+#if PBUF_POOL_LARGE_SIZE
+    unsigned long ulHdr;
+#endif
+
+    stellarisif_stats_get(&lwip_netif, &sStats);
+    UARTprintf("tx queue size:%u queued:%u dropped:%u max depth:%u\n",
+               sStats.txq.size, sStats.txq.enqueued, sStats.txq.dropped,
+               sStats.txq.depth_max);
+    UARTprintf("rx queue size:%u queued:%u dropped:%u max depth:%u\n",
+               sStats.rxq.size, sStats.rxq.enqueued, sStats.rxq.dropped,
+               sStats.rxq.depth_max);
+    UARTprintf("rx %s budget:%u exhausted:%u queue full:%u polls:%u\n",
+               stellarisif_polling(&lwip_netif) ? "polling" : "interrupt",
+               STELLARIS_RX_BUDGET, sStats.rx_budget_exhausted,
+               sStats.rx_queue_full, sStats.rx_polls);
+    UARTprintf("rx filter drops arp:%u ip:%u other:%u\n",
+               sStats.rx_drop_arp, sStats.rx_drop_ip, sStats.rx_drop_other);
+    UARTprintf("rx arp limit drops sender:%u global:%u\n",
+               sStats.rx_arp_limit_src, sStats.rx_arp_limit);
+#if ETHARP_STATS
+    UARTprintf("arp entries not created:%u\n", lwip_stats.etharp.memerr);
+#endif
+    UARTprintf("rx pool reserve:%u no pbuf drops:%u for the reserve:%u\n",
+               STELLARIS_RX_POOL_RESERVE, sStats.rx_no_pbuf,
+               sStats.rx_pool_reserve);
+#if MEMP_STATS
+    UARTprintf("pbuf pool size:%u used:%u max:%u errors:%u\n",
+               lwip_stats.memp[MEMP_PBUF_POOL].avail,
+               lwip_stats.memp[MEMP_PBUF_POOL].used,
+               lwip_stats.memp[MEMP_PBUF_POOL].max,
+               lwip_stats.memp[MEMP_PBUF_POOL].err);
+#if PBUF_POOL_LARGE_SIZE
+    UARTprintf("large pool size:%u used:%u max:%u errors:%u\n",
+               lwip_stats.memp[MEMP_PBUF_POOL_LARGE].avail,
+               lwip_stats.memp[MEMP_PBUF_POOL_LARGE].used,
+               lwip_stats.memp[MEMP_PBUF_POOL_LARGE].max,
+               lwip_stats.memp[MEMP_PBUF_POOL_LARGE].err);
+#endif
+#endif
+#if PBUF_POOL_LARGE_SIZE
     //
-    // Service the lwIP timers.
+    // The memory each pool takes, against the frames that were received
+    // into one large pbuf instead of a chain of small ones.
     //
-    lwIPServiceTimers();
+    ulHdr = LWIP_MEM_ALIGN_SIZE(sizeof(struct pbuf));
+    UARTprintf("rx large:%u chained:%u, pool bytes small:%u large:%u\n",
+               sStats.rx_large, sStats.rx_large_chained,
+               PBUF_POOL_SIZE * (ulHdr + LWIP_MEM_ALIGN_SIZE(PBUF_POOL_BUFSIZE)),
+               PBUF_POOL_LARGE_SIZE *
+               (ulHdr + LWIP_MEM_ALIGN_SIZE(PBUF_POOL_LARGE_BUFSIZE)));
 #endif
+    PerfStatPrint("eth int", &g_sEthIntTime);
 }
 
 //*****************************************************************************
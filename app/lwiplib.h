@@ -81,6 +81,9 @@ extern void lwIPInit(const unsigned char *pucMac, unsigned long ulIPAddr,
                      unsigned long ulIPMode);
 extern void lwIPTimer(unsigned long ulTimeMS);
 extern void lwIPEthernetIntHandler(void);
+extern int lwIPInputTask(void);
+extern int lwIPTimerTask(void);
+extern void lwIPStatsPrint(void);
 extern unsigned long lwIPLocalIPAddrGet(void);
 extern unsigned long lwIPLocalNetMaskGet(void);
 extern unsigned long lwIPLocalGWAddrGet(void);
@@ -44,6 +44,8 @@
 //
 //*****************************************************************************
 #define HOST_TMR_INTERVAL               100         // default is 0
+#define ALARM_TMR_INTERVAL              1000        // default is 0
+#define TELEMETRY_TMR_INTERVAL          100         // default is 0
 //#define DHCP_EXPIRE_TIMER_MSECS         (60 * 1000)
 //#define INCLUDE_HTTPD_SSI
 //#define INCLUDE_HTTPD_CGI
@@ -93,6 +95,7 @@
 //#define MEMP_NUM_TCPIP_MSG_API          8
 //#define MEMP_NUM_TCPIP_MSG_INPKT        8
 #define PBUF_POOL_SIZE                    24    // Default 16, was 36
+#define PBUF_POOL_LARGE_SIZE              4     // Default 0, 1.5KB each
 
 //*****************************************************************************
 //
@@ -101,6 +104,8 @@
 //*****************************************************************************
 //#define LWIP_ARP                        1
 //#define ARP_TABLE_SIZE                  10
+//#define ARP_HASH_SIZE                   16
+#define ETHARP_RECYCLE_ON_INPUT         0
 //#define ARP_QUEUEING                    1
 //#define ETHARP_TRUST_IP_MAC             1
 
@@ -177,6 +182,17 @@
 #define SNMP_PRIVATE_MIB                1
 //#define SNMP_SAFE_REQUESTS              1
 
+//
+// Writes to the BACON output pins are staged per GPIO port during the set
+// pass and committed once per SetRequest.
+//
+extern void BACONSetBegin(void);
+extern void BACONSetCommit(void);
+extern void BACONSetAbort(void);
+#define SNMP_SET_BEGIN_HOOK()           BACONSetBegin()
+#define SNMP_SET_COMMIT_HOOK()          BACONSetCommit()
+#define SNMP_SET_ABORT_HOOK()           BACONSetAbort()
+
 //*****************************************************************************
 //
 // ---------- IGMP options ----------
@@ -253,7 +269,31 @@
 //#define LWIP_NETIF_API                  0
 //#define LWIP_NETIF_STATUS_CALLBACK      0
 //#define LWIP_NETIF_LINK_CALLBACK        0
-//#define LWIP_NETIF_HWADDRHINT           0
+#define LWIP_NETIF_HWADDRHINT           1   // per-PCB ARP entry hints
+
+//*****************************************************************************
+//
+// ---------- Stellaris Ethernet driver options ----------
+//
+//*****************************************************************************
+//#define STELLARIS_NUM_PBUF_QUEUE        20
+//#define STELLARIS_NUM_TX_QUEUE          STELLARIS_NUM_PBUF_QUEUE
+#define STELLARIS_NUM_RX_QUEUE          16          // within the pool less the reserve
+//#define STELLARIS_RX_BUDGET             4
+#define STELLARIS_RX_POOL_RESERVE       6           // default is 0
+#define STELLARIS_RX_FILTER             1           // default is 0
+//#define STELLARIS_RX_MULTICAST          0
+#if LWIP_DHCP
+#define STELLARIS_RX_UDP_PORTS          161, 162, 68 // SNMP, traps, DHCP
+#else
+#define STELLARIS_RX_UDP_PORTS          161, 162    // SNMP, traps
+#endif
+#define STELLARIS_RX_TCP_PORTS          80          // HTTP
+#define STELLARIS_RX_ARP_RATE           20          // default is 0
+//#define STELLARIS_RX_ARP_BURST          STELLARIS_RX_ARP_RATE
+#define STELLARIS_RX_ARP_SRC_RATE       2           // default is 0
+#define STELLARIS_RX_ARP_SRC_BURST      4           // default is the rate
+//#define STELLARIS_RX_ARP_SOURCES        8
 
 //*****************************************************************************
 //
@@ -371,6 +411,8 @@
 //#define CHECKSUM_CHECK_IP               1
 //#define CHECKSUM_CHECK_UDP              1
 //#define CHECKSUM_CHECK_TCP              1
+#define LWIP_CHKSUM_ALGORITHM           4           // 32-bit words, unrolled
+#define LWIP_CHECKSUM_ON_RX             1           // summed by the driver
 
 //*****************************************************************************
 //
@@ -0,0 +1,126 @@
+//*****************************************************************************
+//
+// perfcnt.c - cycle counter helpers used to measure latencies on the target
+//
+//*****************************************************************************
+#include "hw_nvic.h"
+#include "hw_types.h"
+#include "interrupt.h"
+#include "sysctl.h"
+#include "uartstdio.h"
+#include "perfcnt.h"
+
+//*****************************************************************************
+//
+// Nanoseconds per CPU cycle, computed once from the system clock.
+//
+//*****************************************************************************
+static unsigned long g_ulPerfNsPerCycle = 1;
+
+//*****************************************************************************
+//
+// Enable the DWT cycle counter.  Must be called after the system clock has
+// been configured.
+//
+//*****************************************************************************
+void
+PerfCountInit(void)
+{
+    HWREG(NVIC_DBG_INT) |= PERFCNT_DEMCR_TRCENA;
+    HWREG(PERFCNT_DWT_CYCCNT) = 0;
+    HWREG(PERFCNT_DWT_CTRL) |= PERFCNT_DWT_CYCCNTENA;
+
+    g_ulPerfNsPerCycle = 1000000000 / SysCtlClockGet();
+    if(g_ulPerfNsPerCycle == 0)
+    {
+        g_ulPerfNsPerCycle = 1;
+    }
+}
+
+//*****************************************************************************
+//
+// Convert a number of CPU cycles to microseconds.
+//
+//*****************************************************************************
+unsigned long
+PerfCountToUs(unsigned long ulCycles)
+{
+    //
+    // Avoid overflowing the intermediate product for long intervals.
+    //
+    if(ulCycles > (0xFFFFFFFF / g_ulPerfNsPerCycle))
+    {
+        return((ulCycles / 1000) * g_ulPerfNsPerCycle);
+    }
+
+    return((ulCycles * g_ulPerfNsPerCycle) / 1000);
+}
+
+//*****************************************************************************
+//
+// Clear a statistics record.
+//
+//*****************************************************************************
+void
+PerfStatReset(tPerfStat *psStat)
+{
+    psStat->ulCount = 0;
+    psStat->ulLast = 0;
+    psStat->ulMin = 0xFFFFFFFF;
+    psStat->ulMax = 0;
+    psStat->ullTotal = 0;
+}
+
+//*****************************************************************************
+//
+// Add one measured interval to a statistics record.
+//
+//*****************************************************************************
+void
+PerfStatUpdate(tPerfStat *psStat, unsigned long ulCycles)
+{
+    psStat->ulCount++;
+    psStat->ulLast = ulCycles;
+    psStat->ullTotal += ulCycles;
+    if(ulCycles < psStat->ulMin)
+    {
+        psStat->ulMin = ulCycles;
+    }
+    if(ulCycles > psStat->ulMax)
+    {
+        psStat->ulMax = ulCycles;
+    }
+}
+
+//*****************************************************************************
+//
+// Print a statistics record on the console, in microseconds.  The record is
+// copied with interrupts masked, since interrupt handlers update some of
+// them and the total takes two stores.
+//
+//*****************************************************************************
+void
+PerfStatPrint(const char *pcName, const tPerfStat *psStat)
+{
+    tPerfStat sStat;
+    tBoolean bIntsOff;
+
+    bIntsOff = IntMasterDisable();
+    sStat = *psStat;
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+
+    if(sStat.ulCount == 0)
+    {
+        UARTprintf("%s: no samples\n", pcName);
+        return;
+    }
+
+    UARTprintf("%s: n=%u last=%uus min=%uus avg=%uus max=%uus\n", pcName,
+               sStat.ulCount, PerfCountToUs(sStat.ulLast),
+               PerfCountToUs(sStat.ulMin),
+               PerfCountToUs((unsigned long)(sStat.ullTotal / sStat.ulCount)),
+               PerfCountToUs(sStat.ulMax));
+}
@@ -0,0 +1,61 @@
+//*****************************************************************************
+//
+// perfcnt.h - cycle counter helpers used to measure latencies on the target
+//
+//*****************************************************************************
+
+#ifndef __PERFCNT_H__
+#define __PERFCNT_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The Cortex-M3 DWT cycle counter.  It runs at the core clock and wraps
+// every 2^32 cycles, which is several minutes at our clock rate, so simple
+// unsigned subtraction of two samples gives the elapsed cycles.
+//
+//*****************************************************************************
+#define PERFCNT_DWT_CTRL        0xE0001000  // DWT Control
+#define PERFCNT_DWT_CYCCNT      0xE0001004  // DWT Cycle Count
+#define PERFCNT_DEMCR_TRCENA    0x01000000  // Trace enable in NVIC_DBG_INT
+#define PERFCNT_DWT_CYCCNTENA   0x00000001  // Cycle counter enable
+
+#define PerfCountGet()          (*((volatile unsigned long *)PERFCNT_DWT_CYCCNT))
+
+//*****************************************************************************
+//
+// Running statistics of a measured interval, in CPU cycles.  The total is
+// 64 bits wide; 32 bits would wrap after 2^32 cycles of measured time, which
+// a busy task reaches in a few minutes.
+//
+//*****************************************************************************
+typedef struct
+{
+    unsigned long ulCount;
+    unsigned long ulLast;
+    unsigned long ulMin;
+    unsigned long ulMax;
+    unsigned long long ullTotal;
+}
+tPerfStat;
+
+//*****************************************************************************
+//
+// Prototypes for the APIs.
+//
+//*****************************************************************************
+extern void PerfCountInit(void);
+extern unsigned long PerfCountToUs(unsigned long ulCycles);
+extern void PerfStatReset(tPerfStat *psStat);
+extern void PerfStatUpdate(tPerfStat *psStat, unsigned long ulCycles);
+extern void PerfStatPrint(const char *pcName, const tPerfStat *psStat);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __PERFCNT_H__
@@ -40,9 +40,13 @@
 #include "../lwip-1.3.0/src/include/lwip/opt.h"
 #include "../lwip-1.3.0/src/include/lwip/snmp_asn1.h"
 #include "../lwip-1.3.0/src/include/lwip/snmp_structs.h"
+#include "../lwip-1.3.0/src/include/ipv4/lwip/inet.h"
 #include "hw_memmap.h"
 #include "hw_types.h"
 #include "gpio.h"
+#include "bacon.h"
+#include "alarm.h"
+#include "telemetry.h"
 
  
 #if SNMP_PRIVATE_MIB
@@ -58,6 +62,41 @@ extern "C" {
 #define        SNMP_ID          161     // Assigned to SNMP agents by Dave Burns for theCAT.
 #define        BACON_ID         1       // Assigned to BACON by Dave Burns.
 #define        NUM_OF_SENSORS   32       // the number of sensors BACON has.
+#define        BAUD_RATE1_ID    33       // baudRate1, baudRate1R, baudRate2
+                                         // and baudRate2R follow the sensors.
+#define        SENSOR_BITS_ID   37       // all sensors packed in one Gauge32,
+#define        CHANGED_BITS_ID  38       // and the bits changed since last read;
+                                         // reading clears them, for walks and
+                                         // alarm rows as well as Gets.
+#define        GENERATION_ID    39       // bumped on every input change,
+#define        LAST_CHANGE_ID   40       // sysUpTime of the last change.
+#define        RAW_BITS_ID      41       // sensorBits without the input filter.
+#define        NUM_OF_OBJECTS   41
+#define        FILTER_TABLE_ID  2        // baconFilterTable, next to the sensors
+#define        FILTER_DEPTH     1        // baconFilterTable columns
+#define        FILTER_RAW       2
+#define        FILTER_VALUE     3
+#define        NUM_OF_FILTERS   15       // RX_LOS and sensors 19 to 32
+#define        SERIAL_TABLE_ID  3        // baconSerialTable, an activity
+                                         // indicator: edges past
+                                         // BACON_MON_CAP per millisecond
+                                         // are not counted
+#define        SERIAL_EDGES     1        // baconSerialTable columns
+#define        SERIAL_RATE      2
+#define        SERIAL_SATURATED 3
+#define        LINK_TABLE_ID    4        // baconLinkTable, its columns are
+                                         // BACON_LINK_TRANSITIONS to
+                                         // BACON_LINK_LAST_CHANGE
+#define        HISTORY_TABLE_ID 5        // baconHistoryTable
+#define        HISTORY_SEQ      1        // baconHistoryTable columns
+#define        HISTORY_TIME     2
+#define        HISTORY_BITS     3
+#define        HISTORY_CHANGED  4
+#define        ALARM_TABLE_ID   6        // baconAlarmTable, its columns are
+                                         // ALARM_INDEX to ALARM_STATUS
+#define        TELEMETRY_ID     7        // baconTelemetry, its scalars are
+                                         // TELEMETRY_COLLECTOR to
+                                         // TELEMETRY_SKIPPED
  
 // global variables we are returning to the NMS
 u32_t led1 = 0, led2 = 0, beep = 0;
@@ -114,6 +153,41 @@ void BACON_get_obj_def(u8_t id_len, s32_t *id, struct obj_def *rv) {
             rv->asn_type    = (SNMP_ASN1_UNIV | SNMP_ASN1_PRIMIT | SNMP_ASN1_INTEG);
             rv->v_len    = sizeof(u32_t);
             break;
+        case 33: // baudRate1
+        case 34: // baudRate1R
+        case 35: // baudRate2
+        case 36: // baudRate2R
+            // read-only until the selector codes are checked, see
+            // BACON_BAUD_WRITABLE in bacon.h
+            rv->instance    = MIB_OBJECT_SCALAR;
+#if BACON_BAUD_WRITABLE
+            rv->access    = MIB_OBJECT_READ_WRITE;
+#else
+            rv->access    = MIB_OBJECT_READ_ONLY;
+#endif
+            rv->asn_type    = (SNMP_ASN1_UNIV | SNMP_ASN1_PRIMIT | SNMP_ASN1_INTEG);
+            rv->v_len    = sizeof(u32_t);
+            break;
+        case SENSOR_BITS_ID:
+        case CHANGED_BITS_ID:
+        case RAW_BITS_ID:
+            rv->instance    = MIB_OBJECT_SCALAR;
+            rv->access    = MIB_OBJECT_READ_ONLY;
+            rv->asn_type    = (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_GAUGE);
+            rv->v_len    = sizeof(u32_t);
+            break;
+        case GENERATION_ID:
+            rv->instance    = MIB_OBJECT_SCALAR;
+            rv->access    = MIB_OBJECT_READ_ONLY;
+            rv->asn_type    = (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_COUNTER);
+            rv->v_len    = sizeof(u32_t);
+            break;
+        case LAST_CHANGE_ID:
+            rv->instance    = MIB_OBJECT_SCALAR;
+            rv->access    = MIB_OBJECT_READ_ONLY;
+            rv->asn_type    = (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_TIMETICKS);
+            rv->v_len    = sizeof(u32_t);
+            break;
         default: 
             rv->instance    = MIB_OBJECT_SCALAR;
             rv->access    = MIB_OBJECT_READ_ONLY;
@@ -143,105 +217,36 @@ void BACON_get_obj_val(struct obj_def *od, u16_t length, void *value) {
     u32_t *int_ptr = (u32_t*)value;
  
     //LWIP_UNUSED_ARG(length);
-    LWIP_ASSERT("invalid id", (od->id_inst_ptr[0] >=0) && (od->id_inst_ptr[0] <= NUM_OF_SENSORS));
+    LWIP_ASSERT("invalid id", (od->id_inst_ptr[0] >=0) && (od->id_inst_ptr[0] <= NUM_OF_OBJECTS));
     
     oid = (u8_t)od->id_inst_ptr[0];
+    if ((oid >= 1) && (oid <= NUM_OF_SENSORS)) {
+        // outputs come from their RAM shadow and inputs are filtered, see
+        // g_psBACONPins in bacon.c for the pin of every sensor
+        *int_ptr = BACONPinRead(oid);
+        return;
+    }
     switch(oid) {
-    case 1: //FIBER PE3
-        *int_ptr = (GPIOPinRead(GPIO_PORTE_BASE, GPIO_PIN_3) & 0xff) >> 3;
-        break;
-    case 2: // RX_LOS PB2
-        *int_ptr = (GPIOPinRead(GPIO_PORTB_BASE, GPIO_PIN_2) & 0xff) >> 2;
-        break;
-    case 3: // BAUD1_1 PB0
-        *int_ptr = (GPIOPinRead(GPIO_PORTB_BASE, GPIO_PIN_0) & 0xff);
-        break;
-    case 4: // BAUD1_2 PF1
-        *int_ptr = (GPIOPinRead(GPIO_PORTF_BASE, GPIO_PIN_1) & 0xff) >> 1;
-		break;
-	case 5: // BAUD1_3 PF2
-		*int_ptr = (GPIOPinRead(GPIO_PORTF_BASE, GPIO_PIN_2) & 0xff) >> 2;
-        break;
-    case 6: // BAUD1_4 PF3
-        *int_ptr = (GPIOPinRead(GPIO_PORTF_BASE, GPIO_PIN_3) & 0xff) >> 3;
-        break;
-    case 7: // BAUD1_1_R PD3
-        *int_ptr = (GPIOPinRead(GPIO_PORTD_BASE, GPIO_PIN_3) & 0xff) >> 3;
-        break;
-    case 8: // BAUD1_2_R PD2
-        *int_ptr = (GPIOPinRead(GPIO_PORTD_BASE, GPIO_PIN_2) & 0xff) >> 2;
-        break;
-    case 9: // BAUD1_3_R PD1
-        *int_ptr = (GPIOPinRead(GPIO_PORTD_BASE, GPIO_PIN_1) & 0xff) >> 1;
-        break;
-    case 10: // BAUD1_4_R PD0
-        *int_ptr = GPIOPinRead(GPIO_PORTD_BASE, GPIO_PIN_0) & 0xff;
-        break;
-    case 11: // BAUD2_1 PA7
-        *int_ptr = (GPIOPinRead(GPIO_PORTA_BASE, GPIO_PIN_7) & 0xff) >> 7;
-        break;
-    case 12: // BAUD2_2 PA6
-        *int_ptr = (GPIOPinRead(GPIO_PORTA_BASE, GPIO_PIN_6) & 0xff) >> 6;
-        break;
-    case 13: // BAUD2_3 PA5
-        *int_ptr = (GPIOPinRead(GPIO_PORTA_BASE, GPIO_PIN_5) & 0xff) >> 5;
-        break;
-    case 14: // BAUD2_4 PA4
-        *int_ptr = (GPIOPinRead(GPIO_PORTA_BASE, GPIO_PIN_4) & 0xff) >> 4;
-        break;
-    case 15: // BAUD2_1_R PE4
-        *int_ptr = (GPIOPinRead(GPIO_PORTE_BASE, GPIO_PIN_4) & 0xff) >> 4;
-        break;
-    case 16: // BAUD2_2_R PE5
-        *int_ptr = (GPIOPinRead(GPIO_PORTE_BASE, GPIO_PIN_5) & 0xff) >> 5;
-        break;
-    case 17: // BAUD2_3_R PE6
-        *int_ptr = (GPIOPinRead(GPIO_PORTE_BASE, GPIO_PIN_6) & 0xff) >> 6;
-        break;
-    case 18: // BAUD2_4_R PE7
-        *int_ptr = (GPIOPinRead(GPIO_PORTE_BASE, GPIO_PIN_7) & 0xff) >> 7;
-        break;
-    case 19: // TP_Link1 PC7
-        *int_ptr = (GPIOPinRead(GPIO_PORTC_BASE, GPIO_PIN_7) & 0xff) >> 7;
-        break;
-    case 20: // TP_Link2 PC6
-        *int_ptr = (GPIOPinRead(GPIO_PORTC_BASE, GPIO_PIN_6) & 0xff) >> 6;
-        break;
-    case 21: // TP_Link3 PC5
-        *int_ptr = (GPIOPinRead(GPIO_PORTC_BASE, GPIO_PIN_5) & 0xff) >> 5;
-        break;
-    case 22: // TP_Link4 PC4
-        *int_ptr = (GPIOPinRead(GPIO_PORTC_BASE, GPIO_PIN_4) & 0xff) >> 4;
-        break;
-    case 23: // Far_TP_Link1 PB1
-        *int_ptr = (GPIOPinRead(GPIO_PORTB_BASE, GPIO_PIN_1) & 0xff) >> 1;
-        break;
-    case 24: // Far_TP_Link2 PB3
-        *int_ptr = (GPIOPinRead(GPIO_PORTB_BASE, GPIO_PIN_3) & 0xff) >> 3;
-        break;
-    case 25: // Far_TP_Link3 PE0
-        *int_ptr = GPIOPinRead(GPIO_PORTE_BASE, GPIO_PIN_0) & 0xff;
+    case 33: // baudRate1 BAUD1_1-BAUD1_4
+    case 34: // baudRate1R BAUD1_1_R-BAUD1_4_R
+    case 35: // baudRate2 BAUD2_1-BAUD2_4
+    case 36: // baudRate2R BAUD2_1_R-BAUD2_4_R
+        *int_ptr = BACONBaudGet(oid - BAUD_RATE1_ID);
         break;
-    case 26: // Far_TP_Link4 PE1
-        *int_ptr = (GPIOPinRead(GPIO_PORTE_BASE, GPIO_PIN_1) & 0xff) >> 1;
+    case SENSOR_BITS_ID: // bit n-1 holds sensor n
+        *int_ptr = BACONSnapshot();
         break;
-    case 27: // STATUS1 PA2
-        *int_ptr = (GPIOPinRead(GPIO_PORTA_BASE, GPIO_PIN_2) & 0xff) >> 2;
+    case CHANGED_BITS_ID: // read-clear, use generation to poll without side effects
+        *int_ptr = BACONChangedGet();
         break;
-    case 28: // STATUS2 PA3
-        *int_ptr = (GPIOPinRead(GPIO_PORTA_BASE, GPIO_PIN_3) & 0xff) >> 3;
+    case GENERATION_ID:
+        *int_ptr = BACONGenerationGet();
         break;
-    case 29: // RXD1_MON PD6
-        *int_ptr = (GPIOPinRead(GPIO_PORTD_BASE, GPIO_PIN_6) & 0xff) >> 6;
+    case LAST_CHANGE_ID:
+        *int_ptr = BACONLastChangeGet();
         break;
-    case 30: // TXD1_MON PD7
-        *int_ptr = (GPIOPinRead(GPIO_PORTD_BASE, GPIO_PIN_7) & 0xff) >> 7;
-        break;
-    case 31: // RXD2_MON PD4
-        *int_ptr = (GPIOPinRead(GPIO_PORTD_BASE, GPIO_PIN_4) & 0xff) >> 4;
-        break;
-    case 32: // TXD2_MON PD5
-        *int_ptr = (GPIOPinRead(GPIO_PORTD_BASE, GPIO_PIN_5) & 0xff) >> 5;
+    case RAW_BITS_ID:
+        *int_ptr = BACONRawSnapshot();
         break;
     default:
         break;
@@ -273,6 +278,12 @@ static u8_t BACON_set_test(struct obj_def *od, u16_t len, void *value)
     case 18:
         set_ok = 1;
         break;
+    case 33:
+    case 34:
+    case 35:
+    case 36:
+        set_ok = BACONBaudValid(*((u32_t *)value));
+        break;
     default:
         break;
 	}
@@ -286,57 +297,349 @@ static void BACON_set_value(struct obj_def *od, u16_t len, void *value)
 	u32_t val = *((u32_t *)value);
 	
 	id = od->id_inst_ptr[0];
-	switch (id) {    
-    case 3: // BAUD1_1 PB0
-        GPIOPinWrite(GPIO_PORTB_BASE, GPIO_PIN_0, (val & 0xff ? 1 : 0));
-        break;
-    case 4: // BAUD1_2 PF1
-        GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_1, (val & 0xff ? 1 : 0) << 1);
-        break;
-    case 5: // BAUD1_3 PF2
-        GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_2, (val & 0xff ? 1 : 0) << 2);
-        break;
-    case 6: // BAUD1_4 PF3
-        GPIOPinWrite(GPIO_PORTF_BASE, GPIO_PIN_3, (val & 0xff ? 1 : 0) << 3);
-        break;
-    case 7: // BAUD1_1_R PD3
-        GPIOPinWrite(GPIO_PORTD_BASE, GPIO_PIN_3, (val & 0xff ? 1 : 0) << 3);
+	// only staged here, BACONSetCommit() writes every port touched by the
+	// SetRequest at once after all varbinds passed BACON_set_test()
+	if ((id >= BAUD_RATE1_ID) && (id < SENSOR_BITS_ID)) {
+		BACONBaudStage(id - BAUD_RATE1_ID, val);
+	} else {
+		BACONSetStage(id, val & 0xff);
+	}
+}
+ 
+/******************************************************************************
+ * BACON_filter_get_obj_def
+ * Description: Sets the object definition for the baconFilterTable columns
+ * Parameters: u8_t id_len - length of the index being given to us
+ *             s32_t *ident - pointer to the index, preceded by the column
+               struct obj_def *rv - struct we are returning our answer to
+ * Returns: through *rv, the definition of the column being queried
+ ******************************************************************************/
+static void BACON_filter_get_obj_def(u8_t id_len, s32_t *id, struct obj_def *rv) {
+
+    id_len += 1;
+    id -= 1;
+    if (id_len == 2) {
+        rv->id_inst_len = id_len;
+        rv->id_inst_ptr = id;
+        rv->instance = MIB_OBJECT_TAB;
+        rv->asn_type = (SNMP_ASN1_UNIV | SNMP_ASN1_PRIMIT | SNMP_ASN1_INTEG);
+        rv->v_len = sizeof(u32_t);
+        if (id[0] == FILTER_DEPTH) {
+            rv->access = MIB_OBJECT_READ_WRITE;
+        } else {
+            rv->access = MIB_OBJECT_READ_ONLY;
+        }
+    } else {
+        LWIP_DEBUGF(SNMP_MIB_DEBUG,("\r\nBACON_filter_get_obj_def: no such row\r\n"));
+        rv->instance = MIB_OBJECT_NONE;
+    }
+}
+
+static void BACON_filter_get_obj_val(struct obj_def *od, u16_t length, void *value) {
+
+    u32_t *int_ptr = (u32_t*)value;
+    u8_t id = (u8_t)od->id_inst_ptr[1];
+
+    switch(od->id_inst_ptr[0]) {
+    case FILTER_DEPTH: // samples at 1 kHz before an input change is accepted
+        *int_ptr = BACONFilterDepthGet(id);
         break;
-    case 8: // BAUD1_2_R PD2
-        GPIOPinWrite(GPIO_PORTD_BASE, GPIO_PIN_2, (val & 0xff ? 1 : 0) << 2);
+    case FILTER_RAW:
+        *int_ptr = BACONPinReadRaw(id);
         break;
-    case 9: // BAUD1_3_R PD1
-        GPIOPinWrite(GPIO_PORTD_BASE, GPIO_PIN_1, (val & 0xff ? 1 : 0) << 1);
+    case FILTER_VALUE:
+        *int_ptr = BACONPinRead(id);
         break;
-    case 10: // BAUD1_4_R PD0
-        GPIOPinWrite(GPIO_PORTD_BASE, GPIO_PIN_0, (val & 0xff ? 1 : 0));
+    default:
         break;
-    case 11: // BAUD2_1 PA7
-        GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_7, (val & 0xff ? 1 : 0) << 7);
+    }
+}
+
+static u8_t BACON_filter_set_test(struct obj_def *od, u16_t len, void *value)
+{
+	return (od->id_inst_ptr[0] == FILTER_DEPTH) &&
+	       (*((u32_t *)value) <= BACON_FILTER_MAX_DEPTH);
+}
+
+static void BACON_filter_set_value(struct obj_def *od, u16_t len, void *value)
+{
+	BACONFilterDepthSet((u8_t)od->id_inst_ptr[1], *((u32_t *)value));
+}
+ 
+/******************************************************************************
+ * BACON_serial_get_obj_def
+ * Description: Sets the object definition for the baconSerialTable columns
+ * Parameters: u8_t id_len - length of the index being given to us
+ *             s32_t *ident - pointer to the index, preceded by the column
+               struct obj_def *rv - struct we are returning our answer to
+ * Returns: through *rv, the definition of the column being queried
+ ******************************************************************************/
+static void BACON_serial_get_obj_def(u8_t id_len, s32_t *id, struct obj_def *rv) {
+
+    id_len += 1;
+    id -= 1;
+    if (id_len == 2) {
+        rv->id_inst_len = id_len;
+        rv->id_inst_ptr = id;
+        rv->instance = MIB_OBJECT_TAB;
+        rv->access = MIB_OBJECT_READ_ONLY;
+        rv->v_len = sizeof(u32_t);
+        if (id[0] == SERIAL_RATE) {
+            rv->asn_type = (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_GAUGE);
+        } else {
+            rv->asn_type = (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_COUNTER);
+        }
+    } else {
+        LWIP_DEBUGF(SNMP_MIB_DEBUG,("\r\nBACON_serial_get_obj_def: no such row\r\n"));
+        rv->instance = MIB_OBJECT_NONE;
+    }
+}
+
+static void BACON_serial_get_obj_val(struct obj_def *od, u16_t length, void *value) {
+
+    u32_t *int_ptr = (u32_t*)value;
+    u32_t line = od->id_inst_ptr[1] - BACON_ID_RXD1_MON;
+
+    switch(od->id_inst_ptr[0]) {
+    case SERIAL_EDGES: // both edges of the line, up to the cap
+        *int_ptr = BACONMonEdgesGet(line);
         break;
-    case 12: // BAUD2_2 PA6
-        GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_6, (val & 0xff ? 1 : 0) << 6);
+    case SERIAL_RATE: // counted edges in the last second
+        *int_ptr = BACONMonRateGet(line);
         break;
-    case 13: // BAUD2_3 PA5
-        GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_5, (val & 0xff ? 1 : 0) << 5);
+    case SERIAL_SATURATED: // milliseconds in which edges were dropped
+        *int_ptr = BACONMonSaturatedGet(line);
         break;
-    case 14: // BAUD2_4 PA4
-        GPIOPinWrite(GPIO_PORTA_BASE, GPIO_PIN_4, (val & 0xff ? 1 : 0) << 4);
+    default:
         break;
-    case 15: // BAUD2_1_R PE4
-        GPIOPinWrite(GPIO_PORTE_BASE, GPIO_PIN_4, (val & 0xff ? 1 : 0) << 4);
+    }
+}
+ 
+/******************************************************************************
+ * BACON_link_get_obj_def
+ * Description: Sets the object definition for the baconLinkTable columns
+ * Parameters: u8_t id_len - length of the index being given to us
+ *             s32_t *ident - pointer to the index, preceded by the column
+               struct obj_def *rv - struct we are returning our answer to
+ * Returns: through *rv, the definition of the column being queried
+ ******************************************************************************/
+static void BACON_link_get_obj_def(u8_t id_len, s32_t *id, struct obj_def *rv) {
+
+    id_len += 1;
+    id -= 1;
+    if (id_len == 2) {
+        rv->id_inst_len = id_len;
+        rv->id_inst_ptr = id;
+        rv->instance = MIB_OBJECT_TAB;
+        rv->access = MIB_OBJECT_READ_ONLY;
+        rv->v_len = sizeof(u32_t);
+        if (id[0] == BACON_LINK_TRANSITIONS) {
+            rv->asn_type = (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_COUNTER);
+        } else {
+            rv->asn_type = (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_TIMETICKS);
+        }
+    } else {
+        LWIP_DEBUGF(SNMP_MIB_DEBUG,("\r\nBACON_link_get_obj_def: no such row\r\n"));
+        rv->instance = MIB_OBJECT_NONE;
+    }
+}
+
+static void BACON_link_get_obj_val(struct obj_def *od, u16_t length, void *value) {
+
+    // the column is the statistic, the row the sensor id of the link
+    *((u32_t*)value) = BACONLinkGet((u8_t)od->id_inst_ptr[1], od->id_inst_ptr[0]);
+}
+ 
+/******************************************************************************
+ * BACON_history_get_obj_def
+ * Description: Sets the object definition for the baconHistoryTable columns
+ * Parameters: u8_t id_len - length of the index being given to us
+ *             s32_t *ident - pointer to the index, preceded by the column
+               struct obj_def *rv - struct we are returning our answer to
+ * Returns: through *rv, the definition of the column being queried
+ ******************************************************************************/
+static void BACON_history_get_obj_def(u8_t id_len, s32_t *id, struct obj_def *rv) {
+
+    id_len += 1;
+    id -= 1;
+    if ((id_len == 2) && BACONHistoryGet(id[1], NULL)) {
+        rv->id_inst_len = id_len;
+        rv->id_inst_ptr = id;
+        rv->instance = MIB_OBJECT_TAB;
+        rv->access = MIB_OBJECT_READ_ONLY;
+        rv->v_len = sizeof(u32_t);
+        switch(id[0]) {
+        case HISTORY_TIME:
+            rv->asn_type = (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_TIMETICKS);
+            break;
+        case HISTORY_BITS:
+        case HISTORY_CHANGED:
+            rv->asn_type = (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_GAUGE);
+            break;
+        default:
+            rv->asn_type = (SNMP_ASN1_UNIV | SNMP_ASN1_PRIMIT | SNMP_ASN1_INTEG);
+            break;
+        }
+    } else {
+        LWIP_DEBUGF(SNMP_MIB_DEBUG,("\r\nBACON_history_get_obj_def: no such row\r\n"));
+        rv->instance = MIB_OBJECT_NONE;
+    }
+}
+
+static void BACON_history_get_obj_val(struct obj_def *od, u16_t length, void *value) {
+
+    u32_t *int_ptr = (u32_t*)value;
+    tBACONHistory rec;
+
+    // the filter timer interrupts the agent and may have pushed the row out
+    // of the ring since BACON_history_get_obj_def checked it, so take a copy
+    // and check again
+    if (!BACONHistoryGet(od->id_inst_ptr[1], &rec)) {
+        *int_ptr = 0;
+        return;
+    }
+    switch(od->id_inst_ptr[0]) {
+    case HISTORY_SEQ:
+        *int_ptr = rec.ulSeq;
         break;
-    case 16: // BAUD2_2_R PE5
-        GPIOPinWrite(GPIO_PORTE_BASE, GPIO_PIN_5, (val & 0xff ? 1 : 0) << 5);
+    case HISTORY_TIME:
+        *int_ptr = rec.ulUpTime;
         break;
-    case 17: // BAUD2_3_R PE6
-        GPIOPinWrite(GPIO_PORTE_BASE, GPIO_PIN_6, (val & 0xff ? 1 : 0) << 6);
+    case HISTORY_BITS: // sensorBits after the change
+        *int_ptr = rec.ulBits;
         break;
-    case 18: // BAUD2_4_R PE7
-        GPIOPinWrite(GPIO_PORTE_BASE, GPIO_PIN_7, (val & 0xff ? 1 : 0) << 7);
+    case HISTORY_CHANGED:
+        *int_ptr = rec.ulChanged;
         break;
     default:
         break;
+    }
+}
+ 
+/******************************************************************************
+ * BACON_alarm_get_obj_def
+ * Description: Sets the object definition for the baconAlarmTable columns
+ * Parameters: u8_t id_len - length of the index being given to us
+ *             s32_t *ident - pointer to the index, preceded by the column
+               struct obj_def *rv - struct we are returning our answer to
+ * Returns: through *rv, the definition of the column being queried
+ ******************************************************************************/
+static void BACON_alarm_get_obj_def(u8_t id_len, s32_t *id, struct obj_def *rv) {
+
+    s32_t oid[ALARM_OID_LEN];
+
+    id_len += 1;
+    id -= 1;
+    if ((id_len == 2) && (id[0] >= ALARM_INDEX) && (id[0] <= ALARM_STATUS)) {
+        rv->id_inst_len = id_len;
+        rv->id_inst_ptr = id;
+        rv->instance = MIB_OBJECT_TAB;
+        if ((id[0] == ALARM_INDEX) || (id[0] == ALARM_VALUE)) {
+            rv->access = MIB_OBJECT_READ_ONLY;
+        } else {
+            rv->access = MIB_OBJECT_READ_WRITE;
+        }
+        if (id[0] == ALARM_VARIABLE) {
+            rv->asn_type = (SNMP_ASN1_UNIV | SNMP_ASN1_PRIMIT | SNMP_ASN1_OBJ_ID);
+            rv->v_len = AlarmVariableGet(id[1], oid) * sizeof(s32_t);
+        } else {
+            rv->asn_type = (SNMP_ASN1_UNIV | SNMP_ASN1_PRIMIT | SNMP_ASN1_INTEG);
+            rv->v_len = sizeof(s32_t);
+        }
+    } else {
+        LWIP_DEBUGF(SNMP_MIB_DEBUG,("\r\nBACON_alarm_get_obj_def: no such object\r\n"));
+        rv->instance = MIB_OBJECT_NONE;
+    }
+}
+
+static void BACON_alarm_get_obj_val(struct obj_def *od, u16_t length, void *value) {
+
+    if (od->id_inst_ptr[0] == ALARM_VARIABLE) {
+        AlarmVariableGet(od->id_inst_ptr[1], (s32_t*)value);
+    } else {
+        *((s32_t*)value) = AlarmParamGet(od->id_inst_ptr[1], od->id_inst_ptr[0]);
+    }
+}
+
+static u8_t BACON_alarm_set_test(struct obj_def *od, u16_t len, void *value)
+{
+	// alarmStatus can only be set to valid(1) once alarmVariable is set,
+	// by an earlier SetRequest
+	if (od->id_inst_ptr[0] == ALARM_VARIABLE) {
+		return AlarmVariableValid((s32_t *)value, len / sizeof(s32_t));
+	}
+	return AlarmParamValid(od->id_inst_ptr[1], od->id_inst_ptr[0],
+	                       *((s32_t *)value));
+}
+
+static void BACON_alarm_set_value(struct obj_def *od, u16_t len, void *value)
+{
+	if (od->id_inst_ptr[0] == ALARM_VARIABLE) {
+		AlarmVariableSet(od->id_inst_ptr[1], (s32_t *)value, len / sizeof(s32_t));
+	} else {
+		AlarmParamSet(od->id_inst_ptr[1], od->id_inst_ptr[0], *((s32_t *)value));
+	}
+}
+ 
+/******************************************************************************
+ * BACON_telemetry_get_obj_def
+ * Description: Sets the object definition for the baconTelemetry scalars
+ * Parameters: u8_t id_len - length of branch id being given to us
+ *             s32_t *ident - pointer to array holding the id
+               struct obj_def *rv - struct we are returning our answer to
+ * Returns: through *rv, the definition of the object scalar being queried
+ ******************************************************************************/
+static void BACON_telemetry_get_obj_def(u8_t id_len, s32_t *id, struct obj_def *rv) {
+
+    id_len += 1;
+    id -= 1;
+    if (id_len == 2) {
+        rv->id_inst_len = id_len;
+        rv->id_inst_ptr = id;
+        rv->instance = MIB_OBJECT_SCALAR;
+        rv->v_len = sizeof(u32_t);
+        switch(id[0]) {
+        case TELEMETRY_COLLECTOR:
+            rv->access = MIB_OBJECT_READ_WRITE;
+            rv->asn_type = (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_IPADDR);
+            break;
+        case TELEMETRY_PORT:
+        case TELEMETRY_INTERVAL:
+            rv->access = MIB_OBJECT_READ_WRITE;
+            rv->asn_type = (SNMP_ASN1_UNIV | SNMP_ASN1_PRIMIT | SNMP_ASN1_INTEG);
+            break;
+        default:
+            rv->access = MIB_OBJECT_READ_ONLY;
+            rv->asn_type = (SNMP_ASN1_APPLIC | SNMP_ASN1_PRIMIT | SNMP_ASN1_COUNTER);
+            break;
+        }
+    } else {
+        LWIP_DEBUGF(SNMP_MIB_DEBUG,("\r\nBACON_telemetry_get_obj_def: no scalar\r\n"));
+        rv->instance = MIB_OBJECT_NONE;
+    }
+}
+
+static void BACON_telemetry_get_obj_val(struct obj_def *od, u16_t length, void *value) {
+
+    // an IpAddress is encoded from the value as is, in network order
+    if (od->id_inst_ptr[0] == TELEMETRY_COLLECTOR) {
+        *((u32_t*)value) = htonl(TelemetryGet(TELEMETRY_COLLECTOR));
+    } else {
+        *((u32_t*)value) = TelemetryGet(od->id_inst_ptr[0]);
+    }
+}
+
+static u8_t BACON_telemetry_set_test(struct obj_def *od, u16_t len, void *value)
+{
+	return TelemetryValid(od->id_inst_ptr[0], *((u32_t *)value));
+}
+
+static void BACON_telemetry_set_value(struct obj_def *od, u16_t len, void *value)
+{
+	if (od->id_inst_ptr[0] == TELEMETRY_COLLECTOR) {
+		TelemetrySet(TELEMETRY_COLLECTOR, ntohl(*((u32_t *)value)));
+	} else {
+		TelemetrySet(od->id_inst_ptr[0], *((u32_t *)value));
 	}
 }
  
@@ -354,11 +657,12 @@ const mib_scalar_node BACON_sensor = {
     0
 };
  
-// The OIDs for the sensor scalars.
-const s32_t BACON_sensor_oids[32] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
-        13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32};
+// The OIDs for the sensor scalars, followed by the baud rate selectors.
+const s32_t BACON_sensor_oids[NUM_OF_OBJECTS] = { 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12,
+        13, 14, 15, 16, 17, 18, 19, 20, 21, 22, 23, 24, 25, 26, 27, 28, 29, 30, 31, 32,
+        33, 34, 35, 36, 37, 38, 39, 40, 41};
 // The actual structure that holds the nodes.
-struct mib_node* const BACON_sensor_nodes[32] = {
+struct mib_node* const BACON_sensor_nodes[NUM_OF_OBJECTS] = {
 (struct mib_node*)&BACON_sensor, (struct mib_node*)&BACON_sensor,
 (struct mib_node*)&BACON_sensor, (struct mib_node*)&BACON_sensor, 
 (struct mib_node*)&BACON_sensor, (struct mib_node*)&BACON_sensor,
@@ -375,6 +679,11 @@ struct mib_node* const BACON_sensor_nodes[32] = {
 (struct mib_node*)&BACON_sensor, (struct mib_node*)&BACON_sensor, 
 (struct mib_node*)&BACON_sensor, (struct mib_node*)&BACON_sensor,
 (struct mib_node*)&BACON_sensor, (struct mib_node*)&BACON_sensor,
+(struct mib_node*)&BACON_sensor, (struct mib_node*)&BACON_sensor,
+(struct mib_node*)&BACON_sensor, (struct mib_node*)&BACON_sensor,
+(struct mib_node*)&BACON_sensor, (struct mib_node*)&BACON_sensor,
+(struct mib_node*)&BACON_sensor, (struct mib_node*)&BACON_sensor,
+(struct mib_node*)&BACON_sensor,
 };
  
 // 1.3.6.1.4.1.34509.200.161.1.[12345]
@@ -384,15 +693,341 @@ const struct mib_array_node BACON_sensors = {
     &noleafs_set_test,
     &noleafs_set_value,
     MIB_NODE_AR,
-    32,
+    NUM_OF_OBJECTS,
     BACON_sensor_oids,
     BACON_sensor_nodes
 };
  
+// The rows of baconFilterTable, indexed by sensor id.  Only inputs have a
+// filter.
+const s32_t BACON_filter_ids[NUM_OF_FILTERS] = { 2, 19, 20, 21, 22, 23, 24, 25,
+        26, 27, 28, 29, 30, 31, 32};
+struct mib_node* const BACON_filter_rows[NUM_OF_FILTERS] = {
+NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL,
+NULL, NULL, NULL, NULL, NULL, NULL, NULL
+};
+// 1.3.6.1.4.1.34509.200.161.2.1.[123].[id]
+const struct mib_array_node BACON_filter_index = {
+    &BACON_filter_get_obj_def,
+    &BACON_filter_get_obj_val,
+    &BACON_filter_set_test,
+    &BACON_filter_set_value,
+    MIB_NODE_AR,
+    NUM_OF_FILTERS,
+    BACON_filter_ids,
+    BACON_filter_rows
+};
+
+const s32_t BACON_filter_cols[3] = { FILTER_DEPTH, FILTER_RAW, FILTER_VALUE };
+struct mib_node* const BACON_filter_col_nodes[3] = {
+    (struct mib_node*)&BACON_filter_index,
+    (struct mib_node*)&BACON_filter_index,
+    (struct mib_node*)&BACON_filter_index
+};
+// 1.3.6.1.4.1.34509.200.161.2.1
+const struct mib_array_node BACON_filter_entry = {
+    &noleafs_get_object_def,
+    &noleafs_get_value,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    3,
+    BACON_filter_cols,
+    BACON_filter_col_nodes
+};
+
+// the entry id shared by all BACON tables
+const s32_t BACON_entry_ids[1] = { 1 };
+struct mib_node* const BACON_filter_entry_nodes[1] = {
+    (struct mib_node*)&BACON_filter_entry
+};
+// 1.3.6.1.4.1.34509.200.161.2
+const struct mib_array_node BACON_filter_table = {
+    &noleafs_get_object_def,
+    &noleafs_get_value,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    1,
+    BACON_entry_ids,
+    BACON_filter_entry_nodes
+};
+
+
+// The rows of baconSerialTable, indexed by sensor id.
+const s32_t BACON_serial_ids[BACON_NUM_MON] = { 29, 30, 31, 32 };
+struct mib_node* const BACON_serial_rows[BACON_NUM_MON] = {
+NULL, NULL, NULL, NULL
+};
+// 1.3.6.1.4.1.34509.200.161.3.1.[123].[id]
+const struct mib_array_node BACON_serial_index = {
+    &BACON_serial_get_obj_def,
+    &BACON_serial_get_obj_val,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    BACON_NUM_MON,
+    BACON_serial_ids,
+    BACON_serial_rows
+};
+
+const s32_t BACON_serial_cols[3] = { SERIAL_EDGES, SERIAL_RATE, SERIAL_SATURATED };
+struct mib_node* const BACON_serial_col_nodes[3] = {
+    (struct mib_node*)&BACON_serial_index,
+    (struct mib_node*)&BACON_serial_index,
+    (struct mib_node*)&BACON_serial_index
+};
+// 1.3.6.1.4.1.34509.200.161.3.1
+const struct mib_array_node BACON_serial_entry = {
+    &noleafs_get_object_def,
+    &noleafs_get_value,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    3,
+    BACON_serial_cols,
+    BACON_serial_col_nodes
+};
+
+struct mib_node* const BACON_serial_entry_nodes[1] = {
+    (struct mib_node*)&BACON_serial_entry
+};
+// 1.3.6.1.4.1.34509.200.161.3
+const struct mib_array_node BACON_serial_table = {
+    &noleafs_get_object_def,
+    &noleafs_get_value,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    1,
+    BACON_entry_ids,
+    BACON_serial_entry_nodes
+};
+
+
+// The rows of baconLinkTable, indexed by sensor id: RX_LOS, TP_Link1-4 and
+// Far_TP_Link1-4.
+const s32_t BACON_link_ids[BACON_NUM_LINKS] = { 2, 19, 20, 21, 22, 23, 24, 25, 26 };
+struct mib_node* const BACON_link_rows[BACON_NUM_LINKS] = {
+NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL, NULL
+};
+// 1.3.6.1.4.1.34509.200.161.4.1.[1234].[id]
+const struct mib_array_node BACON_link_index = {
+    &BACON_link_get_obj_def,
+    &BACON_link_get_obj_val,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    BACON_NUM_LINKS,
+    BACON_link_ids,
+    BACON_link_rows
+};
+
+const s32_t BACON_link_cols[4] = { BACON_LINK_TRANSITIONS, BACON_LINK_UP_TIME,
+        BACON_LINK_DOWN_TIME, BACON_LINK_LAST_CHANGE };
+struct mib_node* const BACON_link_col_nodes[4] = {
+    (struct mib_node*)&BACON_link_index,
+    (struct mib_node*)&BACON_link_index,
+    (struct mib_node*)&BACON_link_index,
+    (struct mib_node*)&BACON_link_index
+};
+// 1.3.6.1.4.1.34509.200.161.4.1
+const struct mib_array_node BACON_link_entry = {
+    &noleafs_get_object_def,
+    &noleafs_get_value,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    4,
+    BACON_link_cols,
+    BACON_link_col_nodes
+};
+
+struct mib_node* const BACON_link_entry_nodes[1] = {
+    (struct mib_node*)&BACON_link_entry
+};
+// 1.3.6.1.4.1.34509.200.161.4
+const struct mib_array_node BACON_link_table = {
+    &noleafs_get_object_def,
+    &noleafs_get_value,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    1,
+    BACON_entry_ids,
+    BACON_link_entry_nodes
+};
+
+
+// The rows of baconHistoryTable are the sequence numbers of the records in
+// the history ring, oldest first.  Kept by BACON_history_add().
+s32_t BACON_history_ids[BACON_HISTORY_DEPTH];
+struct mib_node* BACON_history_rows[BACON_HISTORY_DEPTH];
+// 1.3.6.1.4.1.34509.200.161.5.1.[1234].[seq]
+struct mib_ram_array_node BACON_history_index = {
+    &BACON_history_get_obj_def,
+    &BACON_history_get_obj_val,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_RA,
+    0,
+    BACON_history_ids,
+    BACON_history_rows
+};
+
+const s32_t BACON_history_cols[4] = { HISTORY_SEQ, HISTORY_TIME, HISTORY_BITS,
+        HISTORY_CHANGED };
+struct mib_node* const BACON_history_col_nodes[4] = {
+    (struct mib_node*)&BACON_history_index,
+    (struct mib_node*)&BACON_history_index,
+    (struct mib_node*)&BACON_history_index,
+    (struct mib_node*)&BACON_history_index
+};
+// 1.3.6.1.4.1.34509.200.161.5.1
+const struct mib_array_node BACON_history_entry = {
+    &noleafs_get_object_def,
+    &noleafs_get_value,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    4,
+    BACON_history_cols,
+    BACON_history_col_nodes
+};
+
+struct mib_node* const BACON_history_entry_nodes[1] = {
+    (struct mib_node*)&BACON_history_entry
+};
+// 1.3.6.1.4.1.34509.200.161.5
+const struct mib_array_node BACON_history_table = {
+    &noleafs_get_object_def,
+    &noleafs_get_value,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    1,
+    BACON_entry_ids,
+    BACON_history_entry_nodes
+};
+
+/******************************************************************************
+ * BACON_history_add
+ * Description: Adds history record seq as the newest row of baconHistoryTable,
+ *              dropping the oldest row once the table is as deep as the ring.
+ *              Called from the BACON task, between the agent's requests.
+ * Parameters: unsigned long seq - sequence number of the new record
+ ******************************************************************************/
+void BACON_history_add(unsigned long seq)
+{
+    u16_t i;
+
+    if (BACON_history_index.maxlength == BACON_HISTORY_DEPTH) {
+        for (i = 1; i < BACON_HISTORY_DEPTH; i++) {
+            BACON_history_ids[i - 1] = BACON_history_ids[i];
+        }
+        BACON_history_index.maxlength--;
+    }
+    BACON_history_ids[BACON_history_index.maxlength] = seq;
+    BACON_history_index.maxlength++;
+}
+
+
+// The rows of baconAlarmTable.
+const s32_t BACON_alarm_ids[ALARM_NUM_ROWS] = { 1, 2, 3, 4 };
+struct mib_node* const BACON_alarm_rows[ALARM_NUM_ROWS] = {
+NULL, NULL, NULL, NULL
+};
+// 1.3.6.1.4.1.34509.200.161.6.1.[1-9].[index]
+const struct mib_array_node BACON_alarm_index = {
+    &BACON_alarm_get_obj_def,
+    &BACON_alarm_get_obj_val,
+    &BACON_alarm_set_test,
+    &BACON_alarm_set_value,
+    MIB_NODE_AR,
+    ALARM_NUM_ROWS,
+    BACON_alarm_ids,
+    BACON_alarm_rows
+};
+
+const s32_t BACON_alarm_cols[9] = { ALARM_INDEX, ALARM_INTERVAL, ALARM_VARIABLE,
+        ALARM_SAMPLE_TYPE, ALARM_VALUE, ALARM_STARTUP, ALARM_RISING, ALARM_FALLING,
+        ALARM_STATUS };
+struct mib_node* const BACON_alarm_col_nodes[9] = {
+    (struct mib_node*)&BACON_alarm_index, (struct mib_node*)&BACON_alarm_index,
+    (struct mib_node*)&BACON_alarm_index, (struct mib_node*)&BACON_alarm_index,
+    (struct mib_node*)&BACON_alarm_index, (struct mib_node*)&BACON_alarm_index,
+    (struct mib_node*)&BACON_alarm_index, (struct mib_node*)&BACON_alarm_index,
+    (struct mib_node*)&BACON_alarm_index
+};
+// 1.3.6.1.4.1.34509.200.161.6.1
+const struct mib_array_node BACON_alarm_entry = {
+    &noleafs_get_object_def,
+    &noleafs_get_value,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    9,
+    BACON_alarm_cols,
+    BACON_alarm_col_nodes
+};
+
+struct mib_node* const BACON_alarm_entry_nodes[1] = {
+    (struct mib_node*)&BACON_alarm_entry
+};
+// 1.3.6.1.4.1.34509.200.161.6
+const struct mib_array_node BACON_alarm_table = {
+    &noleafs_get_object_def,
+    &noleafs_get_value,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    1,
+    BACON_entry_ids,
+    BACON_alarm_entry_nodes
+};
+ 
+// defines the baconTelemetry scalars.
+const mib_scalar_node BACON_telemetry_scalar = {
+    &BACON_telemetry_get_obj_def,
+    &BACON_telemetry_get_obj_val,
+    &BACON_telemetry_set_test,
+    &BACON_telemetry_set_value,
+    MIB_NODE_SC,
+    0
+};
+
+const s32_t BACON_telemetry_oids[5] = { TELEMETRY_COLLECTOR, TELEMETRY_PORT,
+        TELEMETRY_INTERVAL, TELEMETRY_SENT, TELEMETRY_SKIPPED };
+struct mib_node* const BACON_telemetry_nodes[5] = {
+    (struct mib_node*)&BACON_telemetry_scalar,
+    (struct mib_node*)&BACON_telemetry_scalar,
+    (struct mib_node*)&BACON_telemetry_scalar,
+    (struct mib_node*)&BACON_telemetry_scalar,
+    (struct mib_node*)&BACON_telemetry_scalar
+};
+// 1.3.6.1.4.1.34509.200.161.7.[1-5]
+const struct mib_array_node BACON_telemetry = {
+    &noleafs_get_object_def,
+    &noleafs_get_value,
+    &noleafs_set_test,
+    &noleafs_set_value,
+    MIB_NODE_AR,
+    5,
+    BACON_telemetry_oids,
+    BACON_telemetry_nodes
+};
+ 
 // putting them together.
-const s32_t BACON_oids[1] = { BACON_ID };
-struct mib_node* const BACON_nodes[1] = {
-    (struct mib_node*)&BACON_sensors
+const s32_t BACON_oids[7] = { BACON_ID, FILTER_TABLE_ID, SERIAL_TABLE_ID,
+        LINK_TABLE_ID, HISTORY_TABLE_ID, ALARM_TABLE_ID, TELEMETRY_ID };
+struct mib_node* const BACON_nodes[7] = {
+    (struct mib_node*)&BACON_sensors,
+    (struct mib_node*)&BACON_filter_table,
+    (struct mib_node*)&BACON_serial_table,
+    (struct mib_node*)&BACON_link_table,
+    (struct mib_node*)&BACON_history_table,
+    (struct mib_node*)&BACON_alarm_table,
+    (struct mib_node*)&BACON_telemetry
 };
 // 1.3.6.1.4.1.34509.200.161.1
 const struct mib_array_node BACON_mib = {
@@ -401,7 +1036,7 @@ const struct mib_array_node BACON_mib = {
     &noleafs_set_test,
     &noleafs_set_value,
     MIB_NODE_AR,
-    1,
+    7,
     BACON_oids,
     BACON_nodes
 };
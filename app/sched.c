@@ -0,0 +1,210 @@
+//*****************************************************************************
+//
+// sched.c - cooperative run-to-completion task scheduler for the main loop
+//
+// Interrupt handlers only move data and post tasks; the protocol and console
+// work runs here, one task at a time and highest priority first, so a long
+// SNMP walk no longer holds off the SysTick, filter or UART interrupts.  Each
+// task has a time budget it is expected to stop at, and its run times are
+// kept so that a task overrunning its budget shows up on the console.
+//
+//*****************************************************************************
+#include "hw_types.h"
+#include "sysctl.h"
+#include "uartstdio.h"
+#include "perfcnt.h"
+#include "sched.h"
+
+//*****************************************************************************
+//
+// A task and its run-time statistics.
+//
+//*****************************************************************************
+typedef struct
+{
+    const char *pcName;
+    tSchedTask pfnTask;
+    unsigned long ulBudget;                 // in cycles
+    unsigned long ulPosts;
+    unsigned long ulOverruns;
+    tPerfStat sRunTime;
+}
+tSchedTaskInfo;
+
+static tSchedTaskInfo g_psSchedTasks[SCHED_NUM_TASKS];
+
+//*****************************************************************************
+//
+// The run queue, one bit per task.  Bits are set and cleared through the
+// bit-band alias, so interrupt handlers can post without a critical section.
+//
+//*****************************************************************************
+static volatile unsigned long g_ulSchedPending;
+
+//*****************************************************************************
+//
+// The tasks that stopped with work left.  They stay pending but yield to
+// every other pending task, whatever its priority, so that a task that always
+// has more to do cannot starve the ones below it.  Used by SchedRun() only.
+//
+//*****************************************************************************
+static unsigned long g_ulSchedDeferred;
+
+//*****************************************************************************
+//
+// The cycle count when the running task started, and its budget.
+//
+//*****************************************************************************
+static unsigned long g_ulSchedStart;
+static unsigned long g_ulSchedBudget;
+
+//*****************************************************************************
+//
+// The passes of SchedRun() that found no task pending.
+//
+//*****************************************************************************
+static unsigned long g_ulSchedIdle;
+
+//*****************************************************************************
+//
+// Install pfnTask as task ulTask, with a budget of ulBudgetUs microseconds.
+//
+//*****************************************************************************
+void
+SchedTaskSet(unsigned long ulTask, const char *pcName, tSchedTask pfnTask,
+             unsigned long ulBudgetUs)
+{
+    tSchedTaskInfo *psTask;
+
+    if(ulTask >= SCHED_NUM_TASKS)
+    {
+        return;
+    }
+
+    psTask = &g_psSchedTasks[ulTask];
+    psTask->pcName = pcName;
+    psTask->ulBudget = ((SysCtlClockGet() / 1000) * ulBudgetUs) / 1000;
+    PerfStatReset(&psTask->sRunTime);
+    psTask->pfnTask = pfnTask;
+}
+
+//*****************************************************************************
+//
+// Mark task ulTask as ready to run.  Safe to call from any interrupt handler.
+//
+//*****************************************************************************
+void
+SchedPost(unsigned long ulTask)
+{
+    if(ulTask < SCHED_NUM_TASKS)
+    {
+        HWREGBITW(&g_ulSchedPending, ulTask) = 1;
+        g_psSchedTasks[ulTask].ulPosts++;
+    }
+}
+
+//*****************************************************************************
+//
+// Run the highest priority pending task, if any, passing over the deferred
+// tasks until no other task is pending.  Called from the main loop only.
+//
+//*****************************************************************************
+void
+SchedRun(void)
+{
+    tSchedTaskInfo *psTask;
+    unsigned long ulTask, ulCycles, ulReady;
+    int bMore;
+
+    ulReady = g_ulSchedPending;
+    if(!ulReady)
+    {
+        g_ulSchedDeferred = 0;
+        g_ulSchedIdle++;
+        return;
+    }
+    if(ulReady & ~g_ulSchedDeferred)
+    {
+        ulReady &= ~g_ulSchedDeferred;
+    }
+    else
+    {
+        //
+        // Only deferred tasks are left, so they have had their turn.
+        //
+        g_ulSchedDeferred = 0;
+    }
+
+    for(ulTask = 0; ulTask < SCHED_NUM_TASKS; ulTask++)
+    {
+        if(ulReady & (1 << ulTask))
+        {
+            break;
+        }
+    }
+
+    //
+    // Clear the bit before running the task, so that a post made while it
+    // runs is not lost.
+    //
+    HWREGBITW(&g_ulSchedPending, ulTask) = 0;
+    g_ulSchedDeferred &= ~(1 << ulTask);
+    psTask = &g_psSchedTasks[ulTask];
+    if(!psTask->pfnTask)
+    {
+        return;
+    }
+
+    g_ulSchedBudget = psTask->ulBudget;
+    g_ulSchedStart = PerfCountGet();
+    bMore = psTask->pfnTask();
+    ulCycles = PerfCountGet() - g_ulSchedStart;
+
+    PerfStatUpdate(&psTask->sRunTime, ulCycles);
+    if(ulCycles > psTask->ulBudget)
+    {
+        psTask->ulOverruns++;
+    }
+    if(bMore)
+    {
+        g_ulSchedDeferred |= 1 << ulTask;
+        SchedPost(ulTask);
+    }
+}
+
+//*****************************************************************************
+//
+// Return non-zero while the running task is within its budget.
+//
+//*****************************************************************************
+int
+SchedTimeLeft(void)
+{
+    return((PerfCountGet() - g_ulSchedStart) < g_ulSchedBudget);
+}
+
+//*****************************************************************************
+//
+// Print the run-time statistics of the tasks on the console.
+//
+//*****************************************************************************
+void
+SchedStatsPrint(void)
+{
+    tSchedTaskInfo *psTask;
+    unsigned long ulTask;
+
+    UARTprintf("idle passes:%u\n", g_ulSchedIdle);
+    for(ulTask = 0; ulTask < SCHED_NUM_TASKS; ulTask++)
+    {
+        psTask = &g_psSchedTasks[ulTask];
+        if(!psTask->pfnTask)
+        {
+            continue;
+        }
+        UARTprintf("%s: posts:%u budget:%uus overruns:%u\n", psTask->pcName,
+                   psTask->ulPosts, PerfCountToUs(psTask->ulBudget),
+                   psTask->ulOverruns);
+        PerfStatPrint(psTask->pcName, &psTask->sRunTime);
+    }
+}
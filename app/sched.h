@@ -0,0 +1,53 @@
+//*****************************************************************************
+//
+// sched.h - cooperative run-to-completion task scheduler for the main loop
+//
+//*****************************************************************************
+
+#ifndef __SCHED_H__
+#define __SCHED_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The tasks, in priority order.  Lower numbers run first when several tasks
+// are pending.
+//
+//*****************************************************************************
+#define SCHED_TASK_LWIP_INPUT   0           // received frames and transmit
+#define SCHED_TASK_LWIP_TIMER   1           // lwIP, alarm and telemetry timers
+#define SCHED_TASK_BACON        2           // BACON history rows of the MIB
+#define SCHED_TASK_LOG          3           // deferred console messages
+#define SCHED_TASK_CONSOLE      4           // console commands
+#define SCHED_NUM_TASKS         5
+
+//*****************************************************************************
+//
+// A task function.  It should return once SchedTimeLeft() is zero, and
+// return non-zero if it stopped with work left, which posts it again behind
+// the other pending tasks.
+//
+//*****************************************************************************
+typedef int (*tSchedTask)(void);
+
+//*****************************************************************************
+//
+// Prototypes for the APIs.
+//
+//*****************************************************************************
+extern void SchedTaskSet(unsigned long ulTask, const char *pcName,
+                         tSchedTask pfnTask, unsigned long ulBudgetUs);
+extern void SchedPost(unsigned long ulTask);
+extern void SchedRun(void);
+extern int SchedTimeLeft(void);
+extern void SchedStatsPrint(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __SCHED_H__
@@ -12,6 +12,10 @@
 #define EEPROM_IP_ADDR			6
 #define EEPROM_NETMASK_ADDR		10
 #define EEPROM_GATEWAY_ADDR		14
+#define EEPROM_BACON_FILTER_ADDR	18	// one filter depth per BACON pin, 32 bytes
+#define EEPROM_ALARM_ADDR		50	// four alarm rows, 32 bytes each
+#define EEPROM_TRAP_ADDR		178	// trap destination, 4 bytes
+#define EEPROM_TELEMETRY_ADDR		182	// telemetry collector, port, interval, 8 bytes
 
 #endif 
 
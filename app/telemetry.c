@@ -0,0 +1,341 @@
+//*****************************************************************************
+//
+// telemetry.c - periodic UDP push of the BACON state to a collector
+//
+// A fixed size binary report is sent to the collector every interval and
+// whenever the filtered inputs change, so that a collector can follow many
+// boards without polling each of them.  All fields are 32 bit words in
+// network order:
+//
+//   0  magic 'BCN' and TELEMETRY_VERSION
+//   1  report sequence number
+//   2  sysUpTime
+//   3  sensorBits, filtered, bit n - 1 holding sensor n
+//   4  state generation
+//   5  transitions of the BACON_NUM_LINKS links, RX_LOS then TP_Link1-4
+//      and Far_TP_Link1-4
+//  14  edges of the BACON_NUM_MON serial monitor lines
+//  18  ifInOctets, ifInUcastPkts, ifOutOctets, ifOutUcastPkts
+//
+//*****************************************************************************
+#include "hw_types.h"
+#include "interrupt.h"
+#include "uartstdio.h"
+#include "../lwip-1.3.0/src/include/lwip/opt.h"
+#include "../lwip-1.3.0/src/include/lwip/pbuf.h"
+#include "../lwip-1.3.0/src/include/lwip/udp.h"
+#include "../lwip-1.3.0/src/include/lwip/netif.h"
+#include "../lwip-1.3.0/src/include/lwip/snmp.h"
+#include "../lwip-1.3.0/src/include/ipv4/lwip/inet.h"
+#include "softeeprom_wrapper.h"
+#include "storage_config.h"
+#include "bacon.h"
+#include "telemetry.h"
+
+//*****************************************************************************
+//
+// The report layout.
+//
+//*****************************************************************************
+#define TELEMETRY_MAGIC         0x42434E00  // 'B' 'C' 'N' version
+#define TELEMETRY_VERSION       1
+#define TELEMETRY_WORDS         (5 + BACON_NUM_LINKS + BACON_NUM_MON + 4)
+#define TELEMETRY_SIZE          (TELEMETRY_WORDS * 4)
+
+//*****************************************************************************
+//
+// The defaults for an unprogrammed soft EEPROM.
+//
+//*****************************************************************************
+#define TELEMETRY_DEFAULT_PORT  9161
+#define TELEMETRY_DEFAULT_INTERVAL 10
+
+//*****************************************************************************
+//
+// The settings, stored as is in the soft EEPROM at EEPROM_TELEMETRY_ADDR.
+//
+//*****************************************************************************
+typedef struct
+{
+    unsigned long ulCollector;
+    unsigned short usPort;
+    unsigned short usInterval;
+}
+tTelemetryConfig;
+
+static tTelemetryConfig g_sTelemetryConfig;
+
+//*****************************************************************************
+//
+// The UDP PCB and the one report buffer, allocated once.  g_pvTelemetryData
+// is where the report starts in the buffer; udp_sendto() leaves the payload
+// pointing at the headers it prepended.
+//
+//*****************************************************************************
+static struct udp_pcb *g_psTelemetryPCB;
+static struct pbuf *g_psTelemetryBuf;
+static void *g_pvTelemetryData;
+
+//*****************************************************************************
+//
+// The sending state: timer ticks since the last report, the state generation
+// it carried, and the counters.
+//
+//*****************************************************************************
+static unsigned long g_ulTelemetryTicks;
+static unsigned long g_ulTelemetryGeneration;
+static unsigned long g_ulTelemetrySeq;
+static unsigned long g_ulTelemetrySent;
+static unsigned long g_ulTelemetrySkipped;
+
+//*****************************************************************************
+//
+// Load the settings and allocate the PCB and the report buffer.  Must be
+// called after the soft EEPROM and lwIP have been initialized.
+//
+//*****************************************************************************
+void
+TelemetryInit(void)
+{
+    SoftEEPROM_WrapperRead(EEPROM_TELEMETRY_ADDR, sizeof(tTelemetryConfig),
+                           (unsigned char *)&g_sTelemetryConfig);
+    if(g_sTelemetryConfig.ulCollector == 0xFFFFFFFF)
+    {
+        g_sTelemetryConfig.ulCollector = 0;
+    }
+    if(g_sTelemetryConfig.usPort == 0xFFFF)
+    {
+        g_sTelemetryConfig.usPort = TELEMETRY_DEFAULT_PORT;
+    }
+    if(g_sTelemetryConfig.usInterval == 0xFFFF)
+    {
+        g_sTelemetryConfig.usInterval = TELEMETRY_DEFAULT_INTERVAL;
+    }
+
+    g_psTelemetryPCB = udp_new();
+    g_psTelemetryBuf = pbuf_alloc(PBUF_TRANSPORT, TELEMETRY_SIZE, PBUF_RAM);
+    if(g_psTelemetryBuf)
+    {
+        g_pvTelemetryData = g_psTelemetryBuf->payload;
+    }
+}
+
+//*****************************************************************************
+//
+// Fill in and send one report.
+//
+//*****************************************************************************
+static void
+TelemetrySend(unsigned long ulGeneration)
+{
+    struct ip_addr sAddr;
+    unsigned long *pulWord;
+    unsigned long ulUpTime;
+    int i;
+
+    //
+    // The buffer is still held by the Ethernet transmit queue or by an ARP
+    // query if the previous report has not left yet.
+    //
+    if(g_psTelemetryBuf->ref != 1)
+    {
+        g_ulTelemetrySkipped++;
+        return;
+    }
+
+    //
+    // Move the payload back over the headers of the previous report.
+    //
+    pbuf_header(g_psTelemetryBuf,
+                -(s16_t)((u8_t *)g_pvTelemetryData -
+                         (u8_t *)g_psTelemetryBuf->payload));
+
+    pulWord = g_pvTelemetryData;
+    snmp_get_sysuptime(&ulUpTime);
+    *pulWord++ = htonl(TELEMETRY_MAGIC | TELEMETRY_VERSION);
+    *pulWord++ = htonl(++g_ulTelemetrySeq);
+    *pulWord++ = htonl(ulUpTime);
+    *pulWord++ = htonl(BACONSnapshot());
+    *pulWord++ = htonl(ulGeneration);
+    *pulWord++ = htonl(BACONLinkGet(BACON_ID_RX_LOS, BACON_LINK_TRANSITIONS));
+    for(i = 0; i < (BACON_NUM_LINKS - 1); i++)
+    {
+        *pulWord++ = htonl(BACONLinkGet(BACON_ID_TP_LINK1 + i,
+                                        BACON_LINK_TRANSITIONS));
+    }
+    for(i = 0; i < BACON_NUM_MON; i++)
+    {
+        *pulWord++ = htonl(BACONMonEdgesGet(i));
+    }
+    *pulWord++ = htonl(netif_default ? netif_default->ifinoctets : 0);
+    *pulWord++ = htonl(netif_default ? netif_default->ifinucastpkts : 0);
+    *pulWord++ = htonl(netif_default ? netif_default->ifoutoctets : 0);
+    *pulWord++ = htonl(netif_default ? netif_default->ifoutucastpkts : 0);
+
+    sAddr.addr = htonl(g_sTelemetryConfig.ulCollector);
+    if(udp_sendto(g_psTelemetryPCB, g_psTelemetryBuf, &sAddr,
+                  g_sTelemetryConfig.usPort) == ERR_OK)
+    {
+        g_ulTelemetrySent++;
+    }
+}
+
+//*****************************************************************************
+//
+// Send a report when the interval has passed or the inputs have changed.
+// Called every TELEMETRY_TMR_INTERVAL ms from lwIPServiceTimers().
+//
+//*****************************************************************************
+void
+TelemetryTimerHandler(void)
+{
+    unsigned long ulGeneration;
+
+    if((g_sTelemetryConfig.ulCollector == 0) || !g_psTelemetryPCB ||
+       !g_psTelemetryBuf)
+    {
+        return;
+    }
+
+    g_ulTelemetryTicks++;
+    ulGeneration = BACONGenerationGet();
+    if((ulGeneration != g_ulTelemetryGeneration) ||
+       (g_sTelemetryConfig.usInterval &&
+        (g_ulTelemetryTicks >= ((g_sTelemetryConfig.usInterval * 1000) /
+                                TELEMETRY_TMR_INTERVAL))))
+    {
+        g_ulTelemetryTicks = 0;
+        g_ulTelemetryGeneration = ulGeneration;
+        TelemetrySend(ulGeneration);
+    }
+}
+
+//*****************************************************************************
+//
+// Return telemetry setting or counter ulParam.
+//
+//*****************************************************************************
+unsigned long
+TelemetryGet(unsigned long ulParam)
+{
+    switch(ulParam)
+    {
+        case TELEMETRY_COLLECTOR:
+        {
+            return(g_sTelemetryConfig.ulCollector);
+        }
+        case TELEMETRY_PORT:
+        {
+            return(g_sTelemetryConfig.usPort);
+        }
+        case TELEMETRY_INTERVAL:
+        {
+            return(g_sTelemetryConfig.usInterval);
+        }
+        case TELEMETRY_SENT:
+        {
+            return(g_ulTelemetrySent);
+        }
+        case TELEMETRY_SKIPPED:
+        {
+            return(g_ulTelemetrySkipped);
+        }
+        default:
+        {
+            return(0);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Check a new value for telemetry setting ulParam.
+//
+//*****************************************************************************
+int
+TelemetryValid(unsigned long ulParam, unsigned long ulValue)
+{
+    switch(ulParam)
+    {
+        case TELEMETRY_COLLECTOR:
+        {
+            return(1);
+        }
+        case TELEMETRY_PORT:
+        {
+            return((ulValue > 0) && (ulValue <= 0xFFFF));
+        }
+        case TELEMETRY_INTERVAL:
+        {
+            return(ulValue <= 0xFFFF);
+        }
+        default:
+        {
+            return(0);
+        }
+    }
+}
+
+//*****************************************************************************
+//
+// Change telemetry setting ulParam, which has been checked with
+// TelemetryValid(), and store the settings.  May be called from the console,
+// so lwIP is kept out while the settings change.
+//
+//*****************************************************************************
+void
+TelemetrySet(unsigned long ulParam, unsigned long ulValue)
+{
+    tBoolean bIntsOff;
+
+    bIntsOff = IntMasterDisable();
+    switch(ulParam)
+    {
+        case TELEMETRY_COLLECTOR:
+        {
+            g_sTelemetryConfig.ulCollector = ulValue;
+            break;
+        }
+        case TELEMETRY_PORT:
+        {
+            g_sTelemetryConfig.usPort = (unsigned short)ulValue;
+            break;
+        }
+        case TELEMETRY_INTERVAL:
+        {
+            g_sTelemetryConfig.usInterval = (unsigned short)ulValue;
+            break;
+        }
+        default:
+        {
+            break;
+        }
+    }
+    g_ulTelemetryTicks = 0;
+    if(!bIntsOff)
+    {
+        IntMasterEnable();
+    }
+
+    SoftEEPROM_WrapperWrite(EEPROM_TELEMETRY_ADDR, sizeof(tTelemetryConfig),
+                            (unsigned char *)&g_sTelemetryConfig);
+}
+
+//*****************************************************************************
+//
+// Print the telemetry settings and counters on the console.
+//
+//*****************************************************************************
+void
+TelemetryPrint(void)
+{
+    unsigned long ulIP;
+
+    ulIP = g_sTelemetryConfig.ulCollector;
+    UARTprintf("collector:%d.%d.%d.%d:%d interval:%ds\n",
+               (ulIP >> 24) & 0xff, (ulIP >> 16) & 0xff, (ulIP >> 8) & 0xff,
+               ulIP & 0xff, g_sTelemetryConfig.usPort,
+               g_sTelemetryConfig.usInterval);
+    UARTprintf("reports sent:%u skipped:%u\n", g_ulTelemetrySent,
+               g_ulTelemetrySkipped);
+}
@@ -0,0 +1,43 @@
+//*****************************************************************************
+//
+// telemetry.h - periodic UDP push of the BACON state to a collector
+//
+//*****************************************************************************
+
+#ifndef __TELEMETRY_H__
+#define __TELEMETRY_H__
+
+#ifdef __cplusplus
+extern "C"
+{
+#endif
+
+//*****************************************************************************
+//
+// The telemetry settings, numbered like the objects of the baconTelemetry
+// group in the private MIB.
+//
+//*****************************************************************************
+#define TELEMETRY_COLLECTOR     1           // IP address, host order, 0 = off
+#define TELEMETRY_PORT          2           // UDP port of the collector
+#define TELEMETRY_INTERVAL      3           // seconds, 0 = on change only
+#define TELEMETRY_SENT          4           // reports sent
+#define TELEMETRY_SKIPPED       5           // reports skipped, buffer busy
+
+//*****************************************************************************
+//
+// Prototypes for the APIs.
+//
+//*****************************************************************************
+extern void TelemetryInit(void);
+extern void TelemetryTimerHandler(void);
+extern unsigned long TelemetryGet(unsigned long ulParam);
+extern int TelemetryValid(unsigned long ulParam, unsigned long ulValue);
+extern void TelemetrySet(unsigned long ulParam, unsigned long ulValue);
+extern void TelemetryPrint(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // __TELEMETRY_H__
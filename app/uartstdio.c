@@ -97,10 +97,10 @@ volatile unsigned long g_ulUartTxWriteIndex = 0;
 volatile unsigned long g_ulUartTxReadIndex = 0;
 
 //
-// Input ring buffer.  Buffer is full if g_ulUartTxReadIndex is one ahead of
-// g_ulUartTxWriteIndex.  Buffer is empty if the two indices are the same.
+// Input ring buffer.  Buffer is full if g_ulUartRxReadIndex is one ahead of
+// g_ulUartRxWriteIndex.  Buffer is empty if the two indices are the same.
 //
-unsigned char g_pcUartRxBuffer[UART_TX_BUFFER_SIZE];
+unsigned char g_pcUartRxBuffer[UART_RX_BUFFER_SIZE];
 volatile unsigned long g_ulUartRxWriteIndex = 0;
 volatile unsigned long g_ulUartRxReadIndex = 0;
 
@@ -1308,6 +1308,45 @@ UARTPeek(unsigned char ucChar)
 }
 #endif
 
+//*****************************************************************************
+//
+//! Returns the number of bytes available in the receive buffer.
+//!
+//! This function, available only when the module is built to operate in
+//! buffered mode using \b UART_BUFFERED, may be used to determine the number
+//! of bytes of data currently available in the receive buffer.
+//!
+//! \return Returns the number of available bytes.
+//
+//*****************************************************************************
+#if defined(UART_BUFFERED) || defined(DOXYGEN)
+int
+UARTRxBytesAvail(void)
+{
+    return(RX_BUFFER_USED);
+}
+#endif
+
+//*****************************************************************************
+//
+//! Returns the number of bytes free in the transmit buffer.
+//!
+//! This function, available only when the module is built to operate in
+//! buffered mode using \b UART_BUFFERED, may be used to determine the amount
+//! of space currently available in the transmit buffer, so that a caller can
+//! avoid having the end of a message discarded by UARTwrite().
+//!
+//! \return Returns the number of free bytes.
+//
+//*****************************************************************************
+#if defined(UART_BUFFERED) || defined(DOXYGEN)
+int
+UARTTxBytesFree(void)
+{
+    return(TX_BUFFER_FREE);
+}
+#endif
+
 //*****************************************************************************
 //
 //! Flushes the receive buffer.
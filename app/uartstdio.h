@@ -63,7 +63,7 @@ extern "C"
 // buffer.
 //
 //*****************************************************************************
-//#define UART_BUFFERED
+#define UART_BUFFERED
 
 //*****************************************************************************
 //
@@ -93,6 +93,9 @@ extern void UARTprintf(const char *pcString, ...);
 extern int UARTPeek(unsigned char ucChar);
 extern void UARTFlushTx(tBoolean bDiscard);
 extern void UARTFlushRx(void);
+extern int UARTRxBytesAvail(void);
+extern int UARTTxBytesFree(void);
+extern void UARTStdioIntHandler(void);
 #endif
 
 #ifdef __cplusplus
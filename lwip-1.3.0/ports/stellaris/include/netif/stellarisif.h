@@ -45,9 +45,42 @@
 #ifndef __STELLARISIF_H__
 #define __STELLARISIF_H__
 
-extern int stellarisif_input(struct netif *netif);
+/* Statistics of a tx or rx packet queue. */
+struct stellarisif_queue_stats {
+  u32_t size;                 /* packets the queue holds */
+  u32_t enqueued;             /* packets added to the queue */
+  u32_t dropped;              /* packets refused by a full queue */
+  u32_t depth_max;            /* high-water mark of the queue depth */
+};
+
+/* Statistics of the interface. */
+struct stellarisif_stats {
+  struct stellarisif_queue_stats txq;
+  struct stellarisif_queue_stats rxq;
+  u32_t rx_budget_exhausted;  /* interrupts that left packets for polling */
+  u32_t rx_queue_full;        /* packets left in the fifo by a full rx queue */
+  u32_t rx_polls;             /* calls to stellarisif_poll() while polling */
+  u32_t rx_drop_arp;          /* ARP packets for other addresses */
+  u32_t rx_drop_ip;           /* IP packets for unlisted protocols or ports */
+  u32_t rx_drop_other;        /* packets of other ethernet types */
+  u32_t rx_arp_limit_src;     /* ARP packets over the per-sender rate */
+  u32_t rx_arp_limit;         /* ARP packets over the global rate */
+  u32_t rx_no_pbuf;           /* packets dropped for want of pool pbufs */
+  u32_t rx_pool_reserve;      /* of those, to keep the pool reserve */
+  u32_t rx_large;             /* packets received into a large pbuf */
+  u32_t rx_large_chained;     /* large packets chained for want of one */
+};
+
+extern int stellarisif_input(struct netif *netif, int limit);
 extern err_t stellarisif_init(struct netif *netif);
-extern void stellarisif_interrupt(struct netif *netif);
+extern int stellarisif_interrupt(struct netif *netif);
+extern int stellarisif_poll(struct netif *netif, int limit);
+extern int stellarisif_polling(struct netif *netif);
+extern void stellarisif_transmit(struct netif *netif);
+extern void stellarisif_timer(struct netif *netif, u32_t ms);
+extern void stellarisif_tx_copy(struct pbuf *p, volatile unsigned long *dst);
+extern void stellarisif_stats_get(struct netif *netif,
+                                  struct stellarisif_stats *stats);
 
 #if NETIF_DEBUG
 void stellarisif_debug_print(struct pbuf *p);
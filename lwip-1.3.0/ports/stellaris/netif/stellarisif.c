@@ -51,6 +51,7 @@
 #include "lwip/sys.h"
 #include <lwip/stats.h>
 #include <lwip/snmp.h>
+#include "lwip/icmp.h"
 #include "netif/etharp.h"
 #include "netif/ppp_oe.h"
 #include "netif/stellarisif.h"
@@ -71,12 +72,116 @@
 #endif
 
 /**
- * Number of pbufs supported in low-level tx/rx pbuf queue.
+ * Number of pbufs supported in low-level tx/rx pbuf queue.  The tx and rx
+ * queues can be sized separately with STELLARIS_NUM_TX_QUEUE and
+ * STELLARIS_NUM_RX_QUEUE.  A queue holds one pbuf less than its size.
  *
  */
 #ifndef STELLARIS_NUM_PBUF_QUEUE
 #define STELLARIS_NUM_PBUF_QUEUE    20
 #endif
+#ifndef STELLARIS_NUM_TX_QUEUE
+#define STELLARIS_NUM_TX_QUEUE      STELLARIS_NUM_PBUF_QUEUE
+#endif
+#ifndef STELLARIS_NUM_RX_QUEUE
+#define STELLARIS_NUM_RX_QUEUE      STELLARIS_NUM_PBUF_QUEUE
+#endif
+
+/**
+ * Number of packets read from the rx fifo per interrupt.  When packets are
+ * left after that, the rx interrupt is masked and the rest are read by
+ * stellarisif_poll() until the fifo is empty.
+ *
+ */
+#ifndef STELLARIS_RX_BUDGET
+#define STELLARIS_RX_BUDGET         4
+#endif
+
+/**
+ * Receive filter.  When enabled, the first words of each packet are read
+ * from the rx fifo and the packet is dropped without allocating a pbuf
+ * unless it is an ARP packet for our address, an ICMP echo request, or a
+ * UDP or TCP packet for one of the listed ports.  IP fragments and packets
+ * with IP options are passed to the stack.  Multicast reception in the MAC
+ * is only enabled with STELLARIS_RX_MULTICAST or with the filter disabled.
+ *
+ */
+#ifndef STELLARIS_RX_FILTER
+#define STELLARIS_RX_FILTER         0
+#endif
+#ifndef STELLARIS_RX_MULTICAST
+#define STELLARIS_RX_MULTICAST      0
+#endif
+#ifndef STELLARIS_RX_UDP_PORTS
+#define STELLARIS_RX_UDP_PORTS      161
+#endif
+#ifndef STELLARIS_RX_TCP_PORTS
+#define STELLARIS_RX_TCP_PORTS      80
+#endif
+
+/**
+ * ARP rate limits of the receive filter.  ARP packets for our address are
+ * passed at up to STELLARIS_RX_ARP_RATE per second in all, with bursts of
+ * STELLARIS_RX_ARP_BURST, and at up to STELLARIS_RX_ARP_SRC_RATE per second
+ * from any one sender, with bursts of STELLARIS_RX_ARP_SRC_BURST.  Senders
+ * are tracked in STELLARIS_RX_ARP_SOURCES slots, a power of two, picked by
+ * a hash of the sender address.  ARP replies, which answer our own
+ * requests, are held only to the per-sender limit, so that a flood of
+ * requests cannot shut out the gateway's reply.  A rate of 0 disables that
+ * limit.  The limits need stellarisif_timer() to be called.
+ *
+ */
+#ifndef STELLARIS_RX_ARP_RATE
+#define STELLARIS_RX_ARP_RATE       0
+#endif
+#ifndef STELLARIS_RX_ARP_BURST
+#define STELLARIS_RX_ARP_BURST      STELLARIS_RX_ARP_RATE
+#endif
+#ifndef STELLARIS_RX_ARP_SRC_RATE
+#define STELLARIS_RX_ARP_SRC_RATE   0
+#endif
+#ifndef STELLARIS_RX_ARP_SRC_BURST
+#define STELLARIS_RX_ARP_SRC_BURST  STELLARIS_RX_ARP_SRC_RATE
+#endif
+#ifndef STELLARIS_RX_ARP_SOURCES
+#define STELLARIS_RX_ARP_SOURCES    8
+#endif
+#if (STELLARIS_RX_ARP_SOURCES & (STELLARIS_RX_ARP_SOURCES - 1)) != 0
+#error "STELLARIS_RX_ARP_SOURCES must be a power of two!"
+#endif
+#define STELLARIS_RX_ARP_LIMIT      (STELLARIS_RX_FILTER && \
+                                     (STELLARIS_RX_ARP_RATE || \
+                                      STELLARIS_RX_ARP_SRC_RATE))
+
+/**
+ * Pool pbufs the receive path leaves free for transmitted packets.  The
+ * SNMP agent builds its responses and traps in pool pbufs, and without a
+ * reserve a burst of received packets sitting in the rx queue can take the
+ * whole pool.  A packet is dropped when receiving it would leave fewer than
+ * this many pool pbufs free.
+ *
+ */
+#ifndef STELLARIS_RX_POOL_RESERVE
+#define STELLARIS_RX_POOL_RESERVE   0
+#endif
+#if STELLARIS_RX_POOL_RESERVE && !MEMP_STATS
+#error "STELLARIS_RX_POOL_RESERVE needs MEMP_STATS!"
+#endif
+
+/**
+ * Words read from the rx fifo to classify a packet: the length, the ethernet
+ * header and up to the ARP target address or the UDP/TCP destination port.
+ * With LWIP_CHECKSUM_ON_RX they are also read to find the IP total length.
+ *
+ */
+#define STELLARIS_RX_HDR_WORDS      11
+
+/**
+ * The word of the rx fifo the IP header starts at, after the length and
+ * the ethernet header.
+ *
+ */
+#define STELLARIS_RX_IP_WORD        4
 
 /**
  * Setup processing for PTP (IEEE-1588).
@@ -102,12 +207,31 @@ extern void lwIPHostGetTime(u32_t *time_s, u32_t *time_ns);
 #define IFNAME0 'l'
 #define IFNAME1 'm'
 
+#if STELLARIS_RX_FILTER
+/* Ports the receive filter passes, in host byte order. */
+static const u16_t rx_udp_ports[] = { STELLARIS_RX_UDP_PORTS };
+static const u16_t rx_tcp_ports[] = { STELLARIS_RX_TCP_PORTS };
+#endif
+
+#if STELLARIS_RX_ARP_LIMIT
+/**
+ * A token bucket for ARP packets.  Tokens are counted in thousandths, so
+ * that a packet takes 1000 and every millisecond adds the rate.
+ */
+struct arp_bucket {
+  u32_t addr;                 /* the sender, for a per-sender bucket */
+  u32_t tokens;
+  u32_t time;                 /* stellarisif_timer() time of the last refill */
+};
+#endif
+
 /* Helper struct to hold a queue of pbufs for transmit and receive. */
 struct pbufq {
-  struct pbuf *pbuf[STELLARIS_NUM_PBUF_QUEUE];
+  struct pbuf **pbuf;
+  unsigned long size;
   unsigned long qwrite;
   unsigned long qread;
-  unsigned long overflow;
+  struct stellarisif_queue_stats stats;
 };
 
 /* Helper macros for accessing pbuf queues. */
@@ -115,7 +239,7 @@ struct pbufq {
     (((q)->qwrite == (q)->qread) ? true : false)
 
 #define PBUF_QUEUE_FULL(q) \
-    ((((((q)->qwrite + 1) % STELLARIS_NUM_PBUF_QUEUE)) == (q)->qread) ? \
+    ((((((q)->qwrite + 1) % (q)->size)) == (q)->qread) ? \
     true : false )
 
 /**
@@ -129,6 +253,13 @@ struct ethernetif {
   /* Add whatever per-interface state that is needed here. */
   struct pbufq txq;
   struct pbufq rxq;
+  int rxpoll;
+  struct stellarisif_stats stats;
+#if STELLARIS_RX_ARP_LIMIT
+  volatile u32_t time;        /* milliseconds, from stellarisif_timer() */
+  struct arp_bucket arp;
+  struct arp_bucket arp_src[STELLARIS_RX_ARP_SOURCES];
+#endif
 };
 
 /**
@@ -139,6 +270,10 @@ struct ethernetif {
  */
 static struct ethernetif ethernetif_data;
 
+/* Storage for the tx and rx pbuf queues. */
+static struct pbuf *txq_pbufs[STELLARIS_NUM_TX_QUEUE];
+static struct pbuf *rxq_pbufs[STELLARIS_NUM_RX_QUEUE];
+
 /**
  * Pop a pbuf packet from a pbuf packet queue
  *
@@ -170,7 +305,7 @@ dequeue_packet(struct pbufq *q)
      *
      */
     pBuf = q->pbuf[q->qread];
-    q->qread = ((q->qread + 1) % STELLARIS_NUM_PBUF_QUEUE);
+    q->qread = ((q->qread + 1) % q->size);
   }
 
   /* Return to prior interrupt state and return the pbuf pointer. */
@@ -190,6 +325,7 @@ static int
 enqueue_packet(struct pbuf *p, struct pbufq *q)
 {
   SYS_ARCH_DECL_PROTECT(lev);
+  unsigned long depth;
   int ret;
 
   /**
@@ -206,7 +342,12 @@ enqueue_packet(struct pbuf *p, struct pbufq *q)
      *
      */
     q->pbuf[q->qwrite] = p;
-    q->qwrite = ((q->qwrite + 1) % STELLARIS_NUM_PBUF_QUEUE);
+    q->qwrite = ((q->qwrite + 1) % q->size);
+    q->stats.enqueued++;
+    depth = (q->qwrite + q->size - q->qread) % q->size;
+    if(depth > q->stats.depth_max) {
+      q->stats.depth_max = depth;
+    }
     ret = 1;
   }
   else {
@@ -215,7 +356,7 @@ enqueue_packet(struct pbuf *p, struct pbufq *q)
      * of the number of times this happens.
      *
      */
-    q->overflow++;
+    q->stats.dropped++;
     ret = 0;
   }
 
@@ -265,10 +406,16 @@ low_level_init(struct netif *netif)
    * - Enable TX Duplex Mode
    * - Enable TX Padding
    * - Enable TX CRC Generation
-   * - Enable RX Multicast Reception
+   * - Enable RX Multicast Reception, unless the receive filter drops it.
+   *   The MAC has no control for broadcasts; those are left to the filter.
    */
+#if !STELLARIS_RX_FILTER || STELLARIS_RX_MULTICAST
   EthernetConfigSet(ETH_BASE, (ETH_CFG_TX_DPLXEN |ETH_CFG_TX_CRCEN |
     ETH_CFG_TX_PADEN | ETH_CFG_RX_AMULEN));
+#else
+  EthernetConfigSet(ETH_BASE, (ETH_CFG_TX_DPLXEN |ETH_CFG_TX_CRCEN |
+    ETH_CFG_TX_PADEN));
+#endif
 
   /* Enable the Ethernet Controller transmitter and receiver. */
   EthernetEnable(ETH_BASE);
@@ -280,6 +427,89 @@ low_level_init(struct netif *netif)
   EthernetIntEnable(ETH_BASE, ETH_INT_RX | ETH_INT_TX);
 }
 
+/**
+ * Copy a packet, which might be chained, to a 32-bit data register such as
+ * the transmit fifo.  Bytes up to the first word boundary of each pbuf are
+ * gathered one at a time; the rest of the pbuf is read a word at a time
+ * and, when the bytes gathered so far do not fill a word, each word is
+ * merged with them by shifting.  No pbuf is read a byte at a time beyond
+ * its first and last three bytes.
+ *
+ * @param p the packet to copy
+ * @param dst the register to write the packet to
+ */
+void
+stellarisif_tx_copy(struct pbuf *p, volatile unsigned long *dst)
+{
+  struct pbuf *q;
+  const unsigned char *pucBuf;
+  const unsigned long *pulBuf;
+  unsigned long ulGather, ulWord;
+  int iGather, iShift, iLen, iWords;
+
+  /* Initialize the gather register. */
+  ulGather = 0;
+  iGather = 0;
+
+  /* Copy data from the pbuf(s) into the register. */
+  for(q = p; q != NULL; q = q->next) {
+    pucBuf = (const unsigned char *)q->payload;
+    iLen = q->len;
+
+    /* Gather the bytes up to the first word boundary of the pbuf. */
+    while((iLen > 0) && ((unsigned long)pucBuf & 3)) {
+      ulGather |= (unsigned long)*pucBuf++ << (iGather * 8);
+      iLen--;
+      if(++iGather == 4) {
+        *dst = ulGather;
+        ulGather = 0;
+        iGather = 0;
+      }
+    }
+
+    /* Copy the whole words of the pbuf. */
+    pulBuf = (const unsigned long *)pucBuf;
+    iWords = iLen >> 2;
+    if(iGather == 0) {
+      /* In step with the register, four words at a time. */
+      for(; iWords >= 4; iWords -= 4) {
+        *dst = pulBuf[0];
+        *dst = pulBuf[1];
+        *dst = pulBuf[2];
+        *dst = pulBuf[3];
+        pulBuf += 4;
+      }
+      while(iWords-- > 0) {
+        *dst = *pulBuf++;
+      }
+    }
+    else {
+      /* Out of step: merge each word with the bytes gathered before it. */
+      iShift = iGather * 8;
+      while(iWords-- > 0) {
+        ulWord = *pulBuf++;
+        *dst = ulGather | (ulWord << iShift);
+        ulGather = ulWord >> (32 - iShift);
+      }
+    }
+
+    /* Gather the bytes after the last whole word. */
+    pucBuf = (const unsigned char *)pulBuf;
+    iLen &= 3;
+    while(iLen-- > 0) {
+      ulGather |= (unsigned long)*pucBuf++ << (iGather * 8);
+      if(++iGather == 4) {
+        *dst = ulGather;
+        ulGather = 0;
+        iGather = 0;
+      }
+    }
+  }
+
+  /* Send any leftover data. */
+  *dst = ulGather;
+}
+
 /**
  * This function should do the actual transmission of the packet. The packet is
  * contained in the pbuf that is passed to the function. This pbuf might be
@@ -295,14 +525,6 @@ low_level_init(struct netif *netif)
 static err_t
 low_level_transmit(struct netif *netif, struct pbuf *p)
 {
-  int iBuf;
-  unsigned char *pucBuf;
-  unsigned long *pulBuf;
-  struct pbuf *q;
-  int iGather;
-  unsigned long ulGather;
-  unsigned char *pucGather;
-
   /**
    * Fill in the first two bytes of the payload data (configured as padding
    * with ETH_PAD_SIZE = 2) with the total length of the payload data
@@ -311,69 +533,8 @@ low_level_transmit(struct netif *netif, struct pbuf *p)
    */
   *((unsigned short *)(p->payload)) = p->tot_len - 16;
 
-  /* Initialize the gather register. */
-  iGather = 0;
-  pucGather = (unsigned char *)&ulGather;
-  ulGather = 0;
-
-  /* Copy data from the pbuf(s) into the TX Fifo. */
-  for(q = p; q != NULL; q = q->next) {
-    /* Intialize a char pointer and index to the pbuf payload data. */
-    pucBuf = (unsigned char *)q->payload;
-    iBuf = 0;
-
-    /**
-     * If the gather buffer has leftover data from a previous pbuf
-     * in the chain, fill it up and write it to the Tx FIFO.
-     *
-     */
-    while((iBuf < q->len) && (iGather != 0)) {
-      /* Copy a byte from the pbuf into the gather buffer. */
-      pucGather[iGather] = pucBuf[iBuf++];
-
-      /* Increment the gather buffer index modulo 4. */
-      iGather = ((iGather + 1) % 4);
-    }
-
-    /**
-     * If the gather index is 0 and the pbuf index is non-zero,
-     * we have a gather buffer to write into the Tx FIFO.
-     *
-     */
-    if((iGather == 0) && (iBuf != 0)) {
-      HWREG(ETH_BASE + MAC_O_DATA) = ulGather;
-      ulGather = 0;
-    }
-
-    /* Initialze a long pointer into the pbuf for 32-bit access. */
-    pulBuf = (unsigned long *)&pucBuf[iBuf];
-
-    /**
-     * Copy words of pbuf data into the Tx FIFO, but don't go past
-     * the end of the pbuf.
-     *
-     */
-    while((iBuf + 4) <= q->len) {
-      HWREG(ETH_BASE + MAC_O_DATA) = *pulBuf++;
-      iBuf += 4;
-    }
-
-    /**
-     * Check if leftover data in the pbuf and save it in the gather
-     * buffer for the next time.
-     *
-     */
-    while(iBuf < q->len) {
-      /* Copy a byte from the pbuf into the gather buffer. */
-      pucGather[iGather] = pucBuf[iBuf++];
-
-      /* Increment the gather buffer index modulo 4. */
-      iGather = ((iGather + 1) % 4);
-    }
-  }
-
-  /* Send any leftover data to the FIFO. */
-  HWREG(ETH_BASE + MAC_O_DATA) = ulGather;
+  /* Copy data from the pbuf(s) into the Tx FIFO. */
+  stellarisif_tx_copy(p, (volatile unsigned long *)(ETH_BASE + MAC_O_DATA));
 
   /* Wakeup the transmitter. */
   HWREG(ETH_BASE + MAC_O_TR) = MAC_TR_NEWTX;
@@ -443,22 +604,325 @@ low_level_output(struct netif *netif, struct pbuf *p)
   return ERR_OK;
 }
 
+#if STELLARIS_RX_FILTER
+/**
+ * Look for a port in a list of ports.
+ *
+ * @param port the port, in network byte order
+ * @param ports the list, in host byte order
+ * @param num the number of ports in the list
+ * @return 1 if the port is listed, 0 otherwise
+ */
+static int
+low_level_port_listed(u16_t port, const u16_t *ports, int num)
+{
+  port = ntohs(port);
+  while(num-- > 0) {
+    if(*ports++ == port) {
+      return(1);
+    }
+  }
+  return(0);
+}
+
+#if LWIP_CHECKSUM_ON_RX
+/**
+ * Add a word of a received packet to a one's complement sum, adding the
+ * carry back in.
+ */
+#define RX_CHKSUM_ADD(sum, w) do { \
+  u32_t w_ = (w);                  \
+  (sum) += w_;                     \
+  (sum) += ((sum) < w_);           \
+} while (0)
+
+/**
+ * Find the part of a received packet the IP checksum sum covers, from the
+ * first words of the packet in the rx fifo.
+ *
+ * @param hdr the first hdrwords words of the packet
+ * @param hdrwords the words of hdr that were read
+ * @param len the length of the packet, as read from the rx fifo
+ * @param mask set to the mask of the bytes of the IP packet in the word
+ *        after the last whole word of it, 0 if there are none
+ * @return the fifo word after the last whole word of the IP packet, or 0
+ *         if the packet is not an IPv4 packet that fits the frame
+ */
+static int
+low_level_sum_end(const u32_t *hdr, int hdrwords, u16_t len, u32_t *mask)
+{
+  u16_t end;
+
+  *mask = 0;
+  if((hdrwords < STELLARIS_RX_HDR_WORDS) ||
+     (ntohs((u16_t)(hdr[3] >> 16)) != ETHTYPE_IP) ||
+     ((hdr[4] & 0xf0) != 0x40)) {
+    return(0);
+  }
+
+  /* The end of the IP packet, which must leave room for the FCS. */
+  end = ntohs((u16_t)(hdr[4] >> 16));
+  if(end < IP_HLEN) {
+    return(0);
+  }
+  end += STELLARIS_RX_IP_WORD * 4;
+  if((end + 4) > len) {
+    return(0);
+  }
+
+  *mask = (1UL << ((end & 3) * 8)) - 1;
+  return(end >> 2);
+}
+#endif /* LWIP_CHECKSUM_ON_RX */
+
+#if STELLARIS_RX_ARP_LIMIT
+/**
+ * Refill a token bucket for the time since its last refill and take a
+ * token from it.
+ *
+ * @param b the bucket
+ * @param now the current stellarisif_timer() time
+ * @param rate the tokens added per second
+ * @param burst the most tokens the bucket holds
+ * @return 1 if a token was taken, 0 if the bucket is empty
+ */
+static int
+low_level_bucket_take(struct arp_bucket *b, u32_t now, u32_t rate,
+                      u32_t burst)
+{
+  u32_t elapsed;
+
+  /* A full second per token of the burst refills any bucket. */
+  elapsed = now - b->time;
+  if(elapsed > (burst * 1000)) {
+    elapsed = burst * 1000;
+  }
+  b->time = now;
+  b->tokens += elapsed * rate;
+  if(b->tokens > (burst * 1000)) {
+    b->tokens = burst * 1000;
+  }
+
+  if(b->tokens < 1000) {
+    return(0);
+  }
+  b->tokens -= 1000;
+  return(1);
+}
+
+/**
+ * Apply the per-sender and then the global ARP rate limit to an ARP packet
+ * for our address.  A sender over its own limit takes nothing from the
+ * global bucket, so one noisy host does not lock out the others.  Replies
+ * skip the global limit.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param sip the sender protocol address, in network byte order
+ * @param reply 1 if the packet is an ARP reply
+ * @return 1 to receive the packet, 0 to drop it
+ */
+static int
+low_level_arp_limit(struct netif *netif, u32_t sip, int reply)
+{
+  struct ethernetif *ethernetif = netif->state;
+  u32_t now;
+#if STELLARIS_RX_ARP_SRC_RATE
+  struct arp_bucket *b;
+  u32_t h;
+#endif
+
+  now = ethernetif->time;
+
+#if STELLARIS_RX_ARP_SRC_RATE
+  /* Fold the address, so that the slot does not depend on byte order. */
+  h = sip ^ (sip >> 16);
+  h ^= h >> 8;
+  b = &ethernetif->arp_src[h & (STELLARIS_RX_ARP_SOURCES - 1)];
+
+  /**
+   * A new sender takes over the slot with the tokens left in it, so that
+   * senders with made up addresses cannot get a burst each.
+   *
+   */
+  b->addr = sip;
+  if(!low_level_bucket_take(b, now, STELLARIS_RX_ARP_SRC_RATE,
+                            STELLARIS_RX_ARP_SRC_BURST)) {
+    ethernetif->stats.rx_arp_limit_src++;
+    return(0);
+  }
+#endif
+
+#if STELLARIS_RX_ARP_RATE
+  if(!reply && !low_level_bucket_take(&ethernetif->arp, now, STELLARIS_RX_ARP_RATE,
+                            STELLARIS_RX_ARP_BURST)) {
+    ethernetif->stats.rx_arp_limit++;
+    return(0);
+  }
+#endif
+
+  return(1);
+}
+#endif /* STELLARIS_RX_ARP_LIMIT */
+
+/**
+ * Decide from the first words of a packet in the rx fifo whether it is
+ * wanted.  The words are as read from the fifo: the two byte length, then
+ * the packet, in little endian words.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param hdr the first STELLARIS_RX_HDR_WORDS words of the packet
+ * @return 1 to receive the packet, 0 to drop it
+ */
+static int
+low_level_accept(struct netif *netif, const u32_t *hdr)
+{
+  struct ethernetif *ethernetif = netif->state;
+  u16_t type, port;
+
+  type = ntohs((u16_t)(hdr[3] >> 16));
+  if(type == ETHTYPE_ARP) {
+    /* The target protocol address. */
+    if(hdr[10] == netif->ip_addr.addr) {
+#if STELLARIS_RX_ARP_LIMIT
+      /* The sender protocol address straddles two words. */
+      return(low_level_arp_limit(netif, (hdr[7] >> 16) | (hdr[8] << 16),
+                                 ntohs((u16_t)(hdr[5] >> 16)) == ARP_REPLY));
+#else
+      return(1);
+#endif
+    }
+    ethernetif->stats.rx_drop_arp++;
+    return(0);
+  }
+
+  if(type != ETHTYPE_IP) {
+    ethernetif->stats.rx_drop_other++;
+    return(0);
+  }
+
+  /* Leave fragments and options to the stack. */
+  if(((hdr[4] & 0xff) != 0x45) ||
+     ((ntohs((u16_t)(hdr[5] >> 16)) & IP_OFFMASK) != 0)) {
+    return(1);
+  }
+
+  port = (u16_t)(hdr[9] >> 16);
+  switch((hdr[6] >> 8) & 0xff) {
+    case IP_PROTO_ICMP:
+      if((hdr[9] & 0xff) == ICMP_ECHO) {
+        return(1);
+      }
+      break;
+
+    case IP_PROTO_UDP:
+      if(low_level_port_listed(port, rx_udp_ports,
+                               sizeof(rx_udp_ports) / sizeof(u16_t))) {
+        return(1);
+      }
+      break;
+
+    case IP_PROTO_TCP:
+      if(low_level_port_listed(port, rx_tcp_ports,
+                               sizeof(rx_tcp_ports) / sizeof(u16_t))) {
+        return(1);
+      }
+      break;
+
+    default:
+      break;
+  }
+
+  ethernetif->stats.rx_drop_ip++;
+  return(0);
+}
+#endif /* STELLARIS_RX_FILTER */
+
+/**
+ * Check that a packet can be received without taking the pool pbufs kept
+ * for transmitted packets.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param len the length of the packet, as read from the rx fifo
+ * @return 1 if the packet may be allocated, 0 otherwise
+ */
+static int
+low_level_pool_room(struct netif *netif, u16_t len)
+{
+#if STELLARIS_RX_POOL_RESERVE
+  struct ethernetif *ethernetif = netif->state;
+  struct stats_mem *pool = &lwip_stats.memp[MEMP_PBUF_POOL];
+  u16_t needed;
+
+  needed = (len + LWIP_MEM_ALIGN_SIZE(PBUF_POOL_BUFSIZE) - 1) /
+           LWIP_MEM_ALIGN_SIZE(PBUF_POOL_BUFSIZE);
+  if((pool->used + needed + STELLARIS_RX_POOL_RESERVE) > pool->avail) {
+    ethernetif->stats.rx_pool_reserve++;
+    return(0);
+  }
+#endif
+  return(1);
+}
+
+/**
+ * Allocate a pbuf for a received packet.  A packet that does not fit in one
+ * pool pbuf is received into a single large pbuf when one is free, so that
+ * the stack does not walk a chain of small ones.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param len the length of the packet, as read from the rx fifo
+ * @return the pbuf, or NULL if none is available
+ */
+static struct pbuf *
+low_level_alloc(struct netif *netif, u16_t len)
+{
+#if PBUF_POOL_LARGE_SIZE
+  struct ethernetif *ethernetif = netif->state;
+  struct pbuf *p;
+
+  if(len > LWIP_MEM_ALIGN_SIZE(PBUF_POOL_BUFSIZE)) {
+    p = pbuf_alloc_large(len);
+    if(p != NULL) {
+      ethernetif->stats.rx_large++;
+      return(p);
+    }
+    ethernetif->stats.rx_large_chained++;
+  }
+#endif
+
+  /* We allocate a pbuf chain of pbufs from the pool, if it has room. */
+  if(!low_level_pool_room(netif, len)) {
+    return(NULL);
+  }
+  return(pbuf_alloc(PBUF_RAW, len, PBUF_POOL));
+}
+
 /**
  * This function will read a single packet from the Stellaris ethernet
- * interface, if available, and return a pointer to a pbuf.  The timestamp
- * of the packet will be placed into the pbuf structure.
+ * interface and return a pointer to a pbuf.  The timestamp of the packet
+ * will be placed into the pbuf structure.  A packet the receive filter
+ * rejects, or that no pbuf is available for, is drained from the fifo.
+ * The caller must check that a packet is available.
+ *
+ * With LWIP_CHECKSUM_ON_RX the words of an IP packet are summed as they are
+ * copied, and the sum is left in the pbuf for the UDP and TCP checksums.
  *
  * @param netif the lwip network interface structure for this ethernetif
- * @return pointer to pbuf packet if available, NULL otherswise.
+ * @return pointer to pbuf packet, NULL if it was dropped.
  */
 static struct pbuf *
 low_level_receive(struct netif *netif)
 {
+  struct ethernetif *ethernetif = netif->state;
   struct pbuf *p, *q;
   u16_t len;
   u32_t temp;
-  int i;
+  u32_t hdr[STELLARIS_RX_HDR_WORDS];
+  int i, n, words, hdrwords;
   unsigned long *ptr;
+#if LWIP_CHECKSUM_ON_RX
+  u32_t sum, summask;
+  int w, k, sumend;
+#endif
 #if LWIP_PTPD
   u32_t time_s, time_ns;
 
@@ -467,52 +931,115 @@ low_level_receive(struct netif *netif)
 #endif
 
 
-  /* Check if a packet is available, if not, return NULL packet. */
-  if((HWREG(ETH_BASE + MAC_O_NP) & MAC_NP_NPR_M) == 0) {
-    return(NULL);
-  }
-
   /**
    * Obtain the size of the packet and put it into the "len" variable.
    * Note:  The length returned in the FIFO length position includes the
    * two bytes for the length + the 4 bytes for the FCS.
    *
    */
-  temp = HWREG(ETH_BASE + MAC_O_DATA);
-  len = temp & 0xFFFF;
+  hdr[0] = HWREG(ETH_BASE + MAC_O_DATA);
+  len = hdr[0] & 0xFFFF;
+  words = (len + 3) / 4;
+  hdrwords = 1;
+
+#if STELLARIS_RX_FILTER || LWIP_CHECKSUM_ON_RX
+  /* Read the headers and drain the packet if it is not wanted. */
+  if(words >= STELLARIS_RX_HDR_WORDS) {
+    for(; hdrwords < STELLARIS_RX_HDR_WORDS; hdrwords++) {
+      hdr[hdrwords] = HWREG(ETH_BASE + MAC_O_DATA);
+    }
+#if STELLARIS_RX_FILTER
+    if(!low_level_accept(netif, hdr)) {
+      for(i = hdrwords; i < words; i++) {
+        temp = HWREG(ETH_BASE + MAC_O_DATA);
+      }
+      LINK_STATS_INC(link.drop);
+      return(NULL);
+    }
+#endif
+  }
+#endif
 
-  /* We allocate a pbuf chain of pbufs from the pool. */
-  p = pbuf_alloc(PBUF_RAW, len, PBUF_POOL);
+  p = low_level_alloc(netif, len);
 
   /* If a pbuf was allocated, read the packet into the pbuf. */
   if(p != NULL) {
-    /* Place the first word into the first pbuf location. */
-    *(unsigned long *)p->payload = temp;
-    p->payload = (char *)(p->payload) + 4;
-    p->len -= 4;
+    /* Place the words already read into the first pbuf. */
+    ptr = p->payload;
+    for(i = 0; i < hdrwords; i++) {
+      *ptr++ = hdr[i];
+    }
+
+#if LWIP_CHECKSUM_ON_RX
+    /* Sum the words of the IP packet already read. */
+    sum = 0;
+    sumend = low_level_sum_end(hdr, hdrwords, len, &summask);
+    for(w = STELLARIS_RX_IP_WORD; (w < hdrwords) && (w < sumend); w++) {
+      RX_CHKSUM_ADD(sum, hdr[w]);
+    }
+    if((w < hdrwords) && (w == sumend)) {
+      RX_CHKSUM_ADD(sum, hdr[w] & summask);
+    }
+    w = hdrwords;
+#endif
 
-    /* Process all but the last buffer in the pbuf chain. */
+    /* Read the rest, starting after them in the first pbuf. */
     q = p;
+    i = hdrwords * 4;
     while(q != NULL) {
-      /* Setup a byte pointer into the payload section of the pbuf. */
-      ptr = q->payload;
-
       /**
        * Read data from FIFO into the current pbuf
        * (assume pbuf length is modulo 4)
        *
        */
-      for(i = 0; i < q->len; i += 4) {
+      ptr = (unsigned long *)((char *)q->payload + i);
+      n = (q->len - i + 3) / 4;
+
+#if LWIP_CHECKSUM_ON_RX
+      /* Sum the words of the IP packet while copying them... */
+      k = sumend - w;
+      if(k > n) {
+        k = n;
+      }
+      if(k > 0) {
+        n -= k;
+        w += k;
+        while(k-- > 0) {
+          temp = HWREG(ETH_BASE + MAC_O_DATA);
+          *ptr++ = temp;
+          RX_CHKSUM_ADD(sum, temp);
+        }
+      }
+
+      /* ...and the bytes of it in the word after them. */
+      if((n > 0) && (w == sumend)) {
+        temp = HWREG(ETH_BASE + MAC_O_DATA);
+        *ptr++ = temp;
+        RX_CHKSUM_ADD(sum, temp & summask);
+        n--;
+        w++;
+      }
+      w += n;
+#endif
+
+      while(n-- > 0) {
         *ptr++ = HWREG(ETH_BASE + MAC_O_DATA);
       }
 
       /* Link in the next pbuf in the chain. */
       q = q->next;
+      i = 0;
     }
 
-    /* Restore the first pbuf parameters to their original values. */
-    p->payload = (char *)(p->payload) - 4;
-    p->len += 4;
+#if LWIP_CHECKSUM_ON_RX
+    /* Leave the sum, folded to 16 bits, for inet_chksum_pseudo_rx(). */
+    if(sumend) {
+      sum = (sum >> 16) + (sum & 0xffff);
+      sum += (sum >> 16);
+      p->rx_chksum = (u16_t)sum;
+      p->flags |= PBUF_FLAG_RX_CHKSUM;
+    }
+#endif
 
     /* Adjust the link statistics */
     LINK_STATS_INC(link.recv);
@@ -526,11 +1053,12 @@ low_level_receive(struct netif *netif)
 
   /* If no pbuf available, just drain the RX fifo. */
   else {
-    for(i = 4; i < len; i+=4) {
+    for(i = hdrwords; i < words; i++) {
       temp = HWREG(ETH_BASE + MAC_O_DATA);
     }
 
     /* Adjust the link statistics */
+    ethernetif->stats.rx_no_pbuf++;
     LINK_STATS_INC(link.memerr);
     LINK_STATS_INC(link.drop);
   }
@@ -546,9 +1074,12 @@ low_level_receive(struct netif *netif)
  * the appropriate input function is called.
  *
  * @param netif the lwip network interface structure for this ethernetif
+ * @param limit the most packets to process, so that the caller can keep
+ *        to a time budget
+ * @return the number of packets processed
  */
 int
-stellarisif_input(struct netif *netif)
+stellarisif_input(struct netif *netif, int limit)
 {
   struct ethernetif *ethernetif;
   struct pbuf *p;
@@ -557,7 +1088,8 @@ stellarisif_input(struct netif *netif)
   ethernetif = netif->state;
 
   /* move received packet into a new pbuf */
-  while((p = dequeue_packet(&ethernetif->rxq)) != NULL) {
+  while((count < limit) &&
+        ((p = dequeue_packet(&ethernetif->rxq)) != NULL)) {
     count++;
     /* process the packet. */
     if (ethernet_input(p, netif)!=ERR_OK) {
@@ -585,6 +1117,10 @@ stellarisif_input(struct netif *netif)
 err_t
 stellarisif_init(struct netif *netif)
 {
+#if STELLARIS_RX_ARP_LIMIT
+  int i;
+#endif
+
   LWIP_ASSERT("netif != NULL", (netif != NULL));
 
 #if LWIP_NETIF_HOSTNAME
@@ -610,10 +1146,23 @@ stellarisif_init(struct netif *netif)
   netif->linkoutput = low_level_output;
 
   ethernetif_data.ethaddr = (struct eth_addr *)&(netif->hwaddr[0]);
+  ethernetif_data.txq.pbuf = txq_pbufs;
+  ethernetif_data.txq.size = STELLARIS_NUM_TX_QUEUE;
   ethernetif_data.txq.qread = ethernetif_data.txq.qwrite = 0;
-  ethernetif_data.txq.overflow = 0;
+  ethernetif_data.rxq.pbuf = rxq_pbufs;
+  ethernetif_data.rxq.size = STELLARIS_NUM_RX_QUEUE;
   ethernetif_data.rxq.qread = ethernetif_data.rxq.qwrite = 0;
-  ethernetif_data.rxq.overflow = 0;
+  ethernetif_data.rxpoll = 0;
+#if STELLARIS_RX_ARP_LIMIT
+  ethernetif_data.time = 0;
+  ethernetif_data.arp.tokens = STELLARIS_RX_ARP_BURST * 1000;
+  ethernetif_data.arp.time = 0;
+  for(i = 0; i < STELLARIS_RX_ARP_SOURCES; i++) {
+    ethernetif_data.arp_src[i].addr = 0;
+    ethernetif_data.arp_src[i].tokens = STELLARIS_RX_ARP_SRC_BURST * 1000;
+    ethernetif_data.arp_src[i].time = 0;
+  }
+#endif
 
   /* initialize the hardware */
   low_level_init(netif);
@@ -622,57 +1171,193 @@ stellarisif_init(struct netif *netif)
 }
 
 /**
- * Process tx and rx packets at the low-level interrupt.
+ * Move up to limit packets from the rx fifo to the rx queue.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param limit the most packets to move
+ * @return 1 if packets are left in the rx fifo, 0 if it is empty
+ */
+static int
+low_level_receive_queue(struct netif *netif, int limit)
+{
+  struct ethernetif *ethernetif;
+  struct pbuf *p;
+
+  ethernetif = netif->state;
+
+  while((limit-- > 0) && (HWREG(ETH_BASE + MAC_O_NP) & MAC_NP_NPR_M)) {
+    /* Leave the packet in the fifo if there is no room for it. */
+    if(PBUF_QUEUE_FULL(&ethernetif->rxq)) {
+      ethernetif->stats.rx_queue_full++;
+      break;
+    }
+
+    /* Read a packet from the RX fifo, and queue it unless it was dropped. */
+    p = low_level_receive(netif);
+    if(p != NULL) {
+      enqueue_packet(p, &ethernetif->rxq);
+    }
+  }
+
+  return((HWREG(ETH_BASE + MAC_O_NP) & MAC_NP_NPR_M) ? 1 : 0);
+}
+
+/**
+ * Process rx packets at the low-level interrupt.
  *
  * Should be called from the Stellaris Ethernet Interrupt Handler.  This
- * function will read packets from the Stellaris Ethernet fifo and place them
- * into a pbuf queue.  If the transmitter is idle and there is at least one packet
- * on the transmit queue, it will place it in the transmit fifo and start the
- * transmitter.
+ * function will read up to STELLARIS_RX_BUDGET packets from the Stellaris
+ * Ethernet fifo and place them into a pbuf queue for stellarisif_input().
+ * If packets are left, the rx interrupt is masked and the rest must be read
+ * with stellarisif_poll(), which unmasks it again once the fifo is empty.
+ * This keeps a packet storm from holding the CPU in the interrupt.
  *
+ * The transmit queue is not serviced here: low_level_transmit() frees the
+ * pbuf it sent, and with NO_SYS the lwIP heap may only be used from the
+ * context lwIP runs in.  Call stellarisif_transmit() from that context when
+ * the transmit interrupt fires.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @return 1 if the rx fifo is being polled, 0 otherwise
  */
-void
+int
 stellarisif_interrupt(struct netif *netif)
 {
   struct ethernetif *ethernetif;
-  struct pbuf *p;
 
   /* setup pointer to the if state data */
   ethernetif = netif->state;
 
+  /* The fifo is left alone while it is being polled. */
+  if(!ethernetif->rxpoll &&
+     low_level_receive_queue(netif, STELLARIS_RX_BUDGET)) {
+    EthernetIntDisable(ETH_BASE, ETH_INT_RX);
+    ethernetif->rxpoll = 1;
+    ethernetif->stats.rx_budget_exhausted++;
+  }
+
+  return(ethernetif->rxpoll);
+}
+
+/**
+ * Read up to limit packets from the rx fifo while the rx interrupt is
+ * masked, and unmask it once the fifo is empty.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param limit the most packets to read
+ * @return 1 if the rx fifo is still being polled, 0 otherwise
+ */
+int
+stellarisif_poll(struct netif *netif, int limit)
+{
+  struct ethernetif *ethernetif;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  ethernetif = netif->state;
+
+  if(!ethernetif->rxpoll) {
+    return(0);
+  }
+
+  ethernetif->stats.rx_polls++;
+  if(low_level_receive_queue(netif, limit)) {
+    return(1);
+  }
+
   /**
-   * Process the transmit and receive queues as long as there is receive
-   * data available
+   * A packet received after the check raises the rx interrupt as soon as
+   * it is unmasked.
    *
    */
-  p = low_level_receive(netif);
-  while(p != NULL) {
-    /* Add the rx packet to the rx queue */
-    if(!enqueue_packet(p, &ethernetif->rxq)) {
-      /* Could not place the packet on the queue, bail out. */
-      pbuf_free(p);
-      break;
-    }
+  SYS_ARCH_PROTECT(lev);
+  if((HWREG(ETH_BASE + MAC_O_NP) & MAC_NP_NPR_M) == 0) {
+    ethernetif->rxpoll = 0;
+    EthernetIntEnable(ETH_BASE, ETH_INT_RX);
+  }
+  SYS_ARCH_UNPROTECT(lev);
 
-    /* Check if TX fifo is empty and packet available */
-    if((HWREG(ETH_BASE + MAC_O_TR) & MAC_TR_NEWTX) == 0) {
-      p = dequeue_packet(&ethernetif->txq);
-      if(p != NULL) {
-        low_level_transmit(netif, p);
-      }
-    }
+  return(ethernetif->rxpoll);
+}
 
-    /* Read another packet from the RX fifo */
-    p = low_level_receive(netif);
-  }
+/**
+ * Return 1 while the rx fifo is being polled.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ */
+int
+stellarisif_polling(struct netif *netif)
+{
+  struct ethernetif *ethernetif = netif->state;
+
+  return(ethernetif->rxpoll);
+}
+
+/**
+ * Advance the clock of the ARP rate limits.  Should be called periodically,
+ * for example from the system tick.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param ms the milliseconds since the last call
+ */
+void
+stellarisif_timer(struct netif *netif, u32_t ms)
+{
+#if STELLARIS_RX_ARP_LIMIT
+  struct ethernetif *ethernetif = netif->state;
+
+  ethernetif->time += ms;
+#endif
+}
+
+/**
+ * Copy the statistics of the interface and of its packet queues.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ * @param stats where to copy the statistics
+ */
+void
+stellarisif_stats_get(struct netif *netif, struct stellarisif_stats *stats)
+{
+  struct ethernetif *ethernetif = netif->state;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  SYS_ARCH_PROTECT(lev);
+  *stats = ethernetif->stats;
+  stats->txq = ethernetif->txq.stats;
+  stats->txq.size = ethernetif->txq.size - 1;
+  stats->rxq = ethernetif->rxq.stats;
+  stats->rxq.size = ethernetif->rxq.size - 1;
+  SYS_ARCH_UNPROTECT(lev);
+}
 
-  /* One more check of the transmit queue/fifo */
+/**
+ * Start the transmission of the next packet on the transmit queue, if the
+ * transmitter is idle.
+ *
+ * @param netif the lwip network interface structure for this ethernetif
+ */
+void
+stellarisif_transmit(struct netif *netif)
+{
+  struct ethernetif *ethernetif;
+  struct pbuf *p;
+  SYS_ARCH_DECL_PROTECT(lev);
+
+  ethernetif = netif->state;
+
+  /**
+   * Keep low_level_output() from starting the transmitter between the
+   * check and the transmission.
+   *
+   */
+  SYS_ARCH_PROTECT(lev);
   if((HWREG(ETH_BASE + MAC_O_TR) & MAC_TR_NEWTX) == 0) {
     p = dequeue_packet(&ethernetif->txq);
     if(p != NULL) {
       low_level_transmit(netif, p);
     }
   }
+  SYS_ARCH_UNPROTECT(lev);
 }
 
 #if NETIF_DEBUG
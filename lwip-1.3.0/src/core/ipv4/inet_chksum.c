@@ -51,7 +51,7 @@
  * #define LWIP_CHKSUM <your_checksum_routine> 
  *
  * Or you can select from the implementations below by defining
- * LWIP_CHKSUM_ALGORITHM to 1, 2 or 3.
+ * LWIP_CHKSUM_ALGORITHM to 1, 2, 3 or 4.
  */
 
 #ifndef LWIP_CHKSUM
@@ -248,6 +248,91 @@ lwip_standard_chksum(void *dataptr, int len)
 }
 #endif
 
+#if (LWIP_CHKSUM_ALGORITHM == 4) /* Alternative version #4 */
+/** Add a 32-bit word to a 32-bit sum, adding the carry back in. */
+#define LWIP_CHKSUM_ADDC(sum, w) do { \
+  u32_t w_ = (w);                        \
+  (sum) += w_;                           \
+  (sum) += ((sum) < w_);                 \
+} while (0)
+
+/**
+ * A checksum routine for 32-bit processors. Like version #3, but the
+ * bulk of the data is summed a whole word at a time into one 32-bit
+ * accumulator, 16 bytes per loop, with the carry out of every add added
+ * back in, which compilers turn into an add with carry. The head bytes
+ * up to a word boundary and the tail bytes are summed as in version #3.
+ *
+ * @arg start of buffer to be checksummed. May be an odd byte address.
+ * @len number of bytes in the buffer to be checksummed.
+ * @return host order (!) lwip checksum (non-inverted Internet sum) 
+ */
+
+static u16_t
+lwip_standard_chksum(void *dataptr, int len)
+{
+  u8_t *pb = dataptr;
+  u16_t *ps, t = 0;
+  u32_t *pl;
+  u32_t sum = 0;
+  /* starts at odd byte address? */
+  int odd = ((u32_t)pb & 1);
+
+  if (odd && len > 0) {
+    ((u8_t *)&t)[1] = *pb++;
+    len--;
+  }
+
+  ps = (u16_t *)pb;
+
+  if (((u32_t)ps & 3) && len > 1) {
+    sum += *ps++;
+    len -= 2;
+  }
+
+  pl = (u32_t *)ps;
+
+  while (len > 15) {
+    LWIP_CHKSUM_ADDC(sum, pl[0]);
+    LWIP_CHKSUM_ADDC(sum, pl[1]);
+    LWIP_CHKSUM_ADDC(sum, pl[2]);
+    LWIP_CHKSUM_ADDC(sum, pl[3]);
+    pl += 4;
+    len -= 16;
+  }
+
+  while (len > 3) {
+    LWIP_CHKSUM_ADDC(sum, *pl++);
+    len -= 4;
+  }
+
+  /* make room in upper bits */
+  sum = (sum >> 16) + (sum & 0xffff);
+
+  ps = (u16_t *)pl;
+
+  /* 16-bit aligned word remaining? */
+  if (len > 1) {
+    sum += *ps++;
+    len -= 2;
+  }
+
+  /* dangling tail byte remaining? */
+  if (len > 0)                  /* include odd byte */
+    ((u8_t *)&t)[0] = *(u8_t *)ps;
+
+  sum += t;                     /* add end bytes */
+
+  while ((sum >> 16) != 0)      /* combine halves */
+    sum = (sum >> 16) + (sum & 0xffff);
+
+  if (odd)
+    sum = ((sum & 0xff) << 8) | ((sum & 0xff00) >> 8);
+
+  return sum;
+}
+#endif
+
 /* inet_chksum_pseudo:
  *
  * Calculates the pseudo Internet checksum used by TCP and UDP for a pbuf chain.
@@ -304,6 +389,48 @@ inet_chksum_pseudo(struct pbuf *p,
   return (u16_t)~(acc & 0xffffUL);
 }
 
+#if LWIP_CHECKSUM_ON_RX
+/* inet_chksum_pseudo_rx:
+ *
+ * Checks the pseudo Internet checksum of a received TCP or UDP packet like
+ * inet_chksum_pseudo(), but from the sum the network driver took of the IP
+ * packet while receiving it, if it left one (PBUF_FLAG_RX_CHKSUM). That sum
+ * includes the IP header, whose own sum is zero once ip_input() has checked
+ * it, so it is also the sum of the ip data part.
+ *
+ * @param p chain of pbufs of the ip data part, as passed to udp_input()
+ * @param src source ip address (used for checksum of pseudo header)
+ * @param dst destination ip address (used for checksum of pseudo header)
+ * @param proto ip protocol (used for checksum of pseudo header)
+ * @param proto_len length of the ip data part (used for checksum of pseudo header)
+ * @return 0 if the checksum is correct
+ */
+u16_t
+inet_chksum_pseudo_rx(struct pbuf *p,
+       struct ip_addr *src, struct ip_addr *dest,
+       u8_t proto, u16_t proto_len)
+{
+  u32_t acc;
+
+  if ((p->flags & PBUF_FLAG_RX_CHKSUM) == 0) {
+    return inet_chksum_pseudo(p, src, dest, proto, proto_len);
+  }
+
+  acc = p->rx_chksum;
+  acc += (src->addr & 0xffffUL);
+  acc += ((src->addr >> 16) & 0xffffUL);
+  acc += (dest->addr & 0xffffUL);
+  acc += ((dest->addr >> 16) & 0xffffUL);
+  acc += (u32_t)htons((u16_t)proto);
+  acc += (u32_t)htons(proto_len);
+
+  while ((acc >> 16) != 0) {
+    acc = (acc & 0xffffUL) + (acc >> 16);
+  }
+  return (u16_t)~(acc & 0xffffUL);
+}
+#endif /* LWIP_CHECKSUM_ON_RX */
+
 /* inet_chksum_pseudo:
  *
  * Calculates the pseudo Internet checksum used by TCP and UDP for a pbuf chain.
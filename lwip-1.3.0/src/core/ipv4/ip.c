@@ -384,6 +384,10 @@ ip_input(struct pbuf *p, struct netif *inp)
   }
   /* packet consists of multiple fragments? */
   if ((IPH_OFFSET(iphdr) & htons(IP_OFFMASK | IP_MF)) != 0) {
+#if LWIP_CHECKSUM_ON_RX
+    /* the driver's sum only covers this fragment */
+    p->flags &= ~PBUF_FLAG_RX_CHKSUM;
+#endif /* LWIP_CHECKSUM_ON_RX */
 #if IP_REASSEMBLY /* packet fragment reassembly code present? */
     LWIP_DEBUGF(IP_DEBUG, ("IP packet is a fragment (id=0x%04"X16_F" tot_len=%"U16_F" len=%"U16_F" MF=%"U16_F" offset=%"U16_F"), calling ip_reass()\n",
       ntohs(IPH_ID(iphdr)), p->tot_len, ntohs(IPH_LEN(iphdr)), !!(IPH_OFFSET(iphdr) & htons(IP_MF)), (ntohs(IPH_OFFSET(iphdr)) & IP_OFFMASK)*8));
@@ -249,6 +249,39 @@ pbuf_alloc(pbuf_layer layer, u16_t length, pbuf_type type)
   return p;
 }
 
+#if PBUF_POOL_LARGE_SIZE
+/**
+ * Allocates a single PBUF_POOL pbuf from the pool of large pbufs, for a
+ * network driver to receive a frame into without chaining. The payload
+ * starts at the beginning of the buffer, as for a PBUF_RAW pbuf.
+ *
+ * @param length size of the pbuf's payload
+ * @return the allocated pbuf, or NULL if the pool is empty or the length
+ * does not fit in PBUF_POOL_LARGE_BUFSIZE.
+ */
+struct pbuf *
+pbuf_alloc_large(u16_t length)
+{
+  struct pbuf *p;
+
+  if (length > LWIP_MEM_ALIGN_SIZE(PBUF_POOL_LARGE_BUFSIZE)) {
+    return NULL;
+  }
+  p = memp_malloc(MEMP_PBUF_POOL_LARGE);
+  if (p == NULL) {
+    return NULL;
+  }
+  p->type = PBUF_POOL;
+  p->next = NULL;
+  p->payload = LWIP_MEM_ALIGN((void *)((u8_t *)p + SIZEOF_STRUCT_PBUF));
+  p->tot_len = length;
+  p->len = length;
+  p->ref = 1;
+  p->flags = PBUF_FLAG_LARGE;
+  return p;
+}
+#endif /* PBUF_POOL_LARGE_SIZE */
+
 
 /**
  * Shrink a pbuf chain to a desired length.
@@ -495,7 +528,11 @@ pbuf_free(struct pbuf *p)
       type = p->type;
       /* is this a pbuf from the pool? */
       if (type == PBUF_POOL) {
+#if PBUF_POOL_LARGE_SIZE
+        memp_free((p->flags & PBUF_FLAG_LARGE) ? MEMP_PBUF_POOL_LARGE : MEMP_PBUF_POOL, p);
+#else
         memp_free(MEMP_PBUF_POOL, p);
+#endif
       /* is this a ROM or RAM referencing pbuf? */
       } else if (type == PBUF_ROM || type == PBUF_REF) {
         memp_free(MEMP_PBUF, p);
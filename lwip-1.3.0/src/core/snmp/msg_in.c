@@ -103,6 +103,11 @@ snmp_error_response(struct snmp_msg_pstat *msg_ps, u8_t error)
   msg_ps->invb.count = 0;
   msg_ps->error_status = error;
   msg_ps->error_index = 1 + msg_ps->vb_idx;
+  if (msg_ps->rt == SNMP_ASN1_PDU_SET_REQ)
+  {
+    /* drop anything staged by the set pass */
+    SNMP_SET_ABORT_HOOK();
+  }
   snmp_send_response(msg_ps);
   snmp_varbind_list_free(&msg_ps->outvb);
   msg_ps->state = SNMP_MSG_EMPTY;
@@ -598,6 +603,11 @@ snmp_msg_set_event(u8_t request_id, struct snmp_msg_pstat *msg_ps)
     msg_ps->vb_idx += 1;
   }
 
+  if ((msg_ps->state == SNMP_MSG_SEARCH_OBJ) && (msg_ps->vb_idx == 0))
+  {
+    SNMP_SET_BEGIN_HOOK();
+  }
+
   /* test all values before setting */
   while ((msg_ps->state == SNMP_MSG_SEARCH_OBJ) &&
          (msg_ps->vb_idx < msg_ps->invb.count))
@@ -746,6 +756,7 @@ snmp_msg_set_event(u8_t request_id, struct snmp_msg_pstat *msg_ps)
     /* simply echo the input if we can set it
        @todo do we need to return the actual value?
        e.g. if value is silently modified or behaves sticky? */
+    SNMP_SET_COMMIT_HOOK();
     msg_ps->outvb = msg_ps->invb;
     msg_ps->invb.head = NULL;
     msg_ps->invb.tail = NULL;
@@ -207,7 +207,8 @@ snmp_send_response(struct snmp_msg_pstat *m_stat)
  * @param generic_trap is the trap code
  * @param eoid points to enterprise object identifier
  * @param specific_trap used for enterprise traps when generic_trap == 6
- * @return ERR_OK when success, ERR_MEM if we're out of memory
+ * @return ERR_OK when success, ERR_MEM if we're out of memory or the
+ * trap could not be queued for sending, so that the caller can retry later
  *
  * @note the caller is responsible for filling in outvb in the trap_msg
  * @note the use of the enterpise identifier field
@@ -224,6 +225,7 @@ snmp_send_trap(s8_t generic_trap, struct snmp_obj_id *eoid, s32_t specific_trap)
   struct ip_addr dst_ip;
   struct pbuf *p;
   u16_t i,tot_len;
+  err_t err, ret = ERR_OK;
 
   for (i=0, td = &trap_dst[0]; i<SNMP_TRAP_DESTINATIONS; i++, td++)
   {
@@ -271,7 +273,12 @@ snmp_send_trap(s8_t generic_trap, struct snmp_obj_id *eoid, s32_t specific_trap)
 
         /** connect to the TRAP destination */
         udp_connect(trap_msg.pcb, &trap_msg.dip, SNMP_TRAP_PORT);
-        udp_send(trap_msg.pcb, p);
+        err = udp_send(trap_msg.pcb, p);
+        if (err != ERR_OK)
+        {
+          /* e.g. the netif transmit queue is full */
+          ret = err;
+        }
         /** disassociate remote address and port with this pcb */
         udp_disconnect(trap_msg.pcb);
 
@@ -283,7 +290,7 @@ snmp_send_trap(s8_t generic_trap, struct snmp_obj_id *eoid, s32_t specific_trap)
       }
     }
   }
-  return ERR_OK;
+  return ret;
 }
 
 void
@@ -49,6 +49,13 @@ u16_t inet_chksum_pseudo(struct pbuf *p,
 u16_t inet_chksum_pseudo_partial(struct pbuf *p,
        struct ip_addr *src, struct ip_addr *dest,
        u8_t proto, u16_t proto_len, u16_t chksum_len);
+#if LWIP_CHECKSUM_ON_RX
+u16_t inet_chksum_pseudo_rx(struct pbuf *p,
+       struct ip_addr *src, struct ip_addr *dest,
+       u8_t proto, u16_t proto_len);
+#else /* LWIP_CHECKSUM_ON_RX */
+#define inet_chksum_pseudo_rx inet_chksum_pseudo
+#endif /* LWIP_CHECKSUM_ON_RX */
 
 #ifdef __cplusplus
 }
@@ -80,6 +80,9 @@ LWIP_MEMPOOL(SYS_TIMEOUT,    MEMP_NUM_SYS_TIMEOUT,     sizeof(struct sys_timeo),
  */
 LWIP_PBUF_MEMPOOL(PBUF,      MEMP_NUM_PBUF,            0,                             "PBUF_REF/ROM")
 LWIP_PBUF_MEMPOOL(PBUF_POOL, PBUF_POOL_SIZE,           PBUF_POOL_BUFSIZE,             "PBUF_POOL")
+#if PBUF_POOL_LARGE_SIZE
+LWIP_PBUF_MEMPOOL(PBUF_POOL_LARGE, PBUF_POOL_LARGE_SIZE, PBUF_POOL_LARGE_BUFSIZE,    "PBUF_POOL_LARGE")
+#endif /* PBUF_POOL_LARGE_SIZE */
 
 
 /*
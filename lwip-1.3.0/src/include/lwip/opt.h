@@ -288,6 +288,15 @@
 #define PBUF_POOL_SIZE                  16
 #endif
 
+/**
+ * PBUF_POOL_LARGE_SIZE: the number of buffers in the pool of large pbufs
+ * that a network driver can receive a frame into without chaining, with
+ * pbuf_alloc_large(). 0 leaves the pool out.
+ */
+#ifndef PBUF_POOL_LARGE_SIZE
+#define PBUF_POOL_LARGE_SIZE            0
+#endif
+
 /*
    ---------------------------------
    ---------- ARP options ----------
@@ -307,6 +316,24 @@
 #define ARP_TABLE_SIZE                  10
 #endif
 
+/**
+ * ARP_HASH_SIZE: Number of hash chains indexing the ARP table by IP address,
+ * a power of two. Lookups walk one chain instead of scanning the table.
+ */
+#ifndef ARP_HASH_SIZE
+#define ARP_HASH_SIZE                   16
+#endif
+
+/**
+ * ETHARP_RECYCLE_ON_INPUT==1: An ARP packet for our address may recycle the
+ * oldest entry when the table is full. Set to 0 so that senders that are not
+ * in the table yet only get a free entry, and a flood of requests from
+ * spoofed addresses cannot push out the entries of hosts we talk to.
+ */
+#ifndef ETHARP_RECYCLE_ON_INPUT
+#define ETHARP_RECYCLE_ON_INPUT         1
+#endif
+
 /**
  * ARP_QUEUEING==1: Outgoing packets are queued during hardware address
  * resolution.
@@ -558,6 +585,24 @@
 #define SNMP_SAFE_REQUESTS              1
 #endif
 
+/**
+ * SNMP_SET_BEGIN_HOOK(), SNMP_SET_COMMIT_HOOK(), SNMP_SET_ABORT_HOOK():
+ * Called when a SetRequest starts testing its varbinds, after set_value()
+ * has been called for all of them, and when it is rejected. A private MIB
+ * can use these to stage writes in set_value() and apply them together.
+ */
+#ifndef SNMP_SET_BEGIN_HOOK
+#define SNMP_SET_BEGIN_HOOK()
+#endif
+
+#ifndef SNMP_SET_COMMIT_HOOK
+#define SNMP_SET_COMMIT_HOOK()
+#endif
+
+#ifndef SNMP_SET_ABORT_HOOK
+#define SNMP_SET_ABORT_HOOK()
+#endif
+
 /*
    ----------------------------------
    ---------- IGMP options ----------
@@ -792,6 +837,14 @@
 #define PBUF_POOL_BUFSIZE               LWIP_MEM_ALIGN_SIZE(TCP_MSS+40+PBUF_LINK_HLEN)
 #endif
 
+/**
+ * PBUF_POOL_LARGE_BUFSIZE: the size of each pbuf in the pool of large pbufs.
+ * The default holds a full size frame with its link header and a 4 byte FCS.
+ */
+#ifndef PBUF_POOL_LARGE_BUFSIZE
+#define PBUF_POOL_LARGE_BUFSIZE         LWIP_MEM_ALIGN_SIZE(PBUF_LINK_HLEN+1500+4)
+#endif
+
 /*
    ------------------------------------------------
    ---------- Network Interfaces options ----------
@@ -1421,6 +1474,16 @@
 #define CHECKSUM_CHECK_TCP              1
 #endif
 
+/**
+ * LWIP_CHECKSUM_ON_RX==1: The network driver sums each received IP packet
+ * while it copies it and leaves the sum in the pbuf, so that UDP and TCP
+ * check their checksums without reading the data again. Drivers that do not
+ * set PBUF_FLAG_RX_CHKSUM are checked as before. Needs CHECKSUM_CHECK_IP.
+ */
+#ifndef LWIP_CHECKSUM_ON_RX
+#define LWIP_CHECKSUM_ON_RX             0
+#endif
+
 /*
    ---------------------------------------
    ---------- Debugging options ----------
@@ -60,6 +60,10 @@ typedef enum {
 
 /** indicates this packet's data should be immediately passed to the application */
 #define PBUF_FLAG_PUSH 0x01U
+/** indicates this pbuf is from the pool of large pbufs */
+#define PBUF_FLAG_LARGE 0x02U
+/** indicates rx_chksum holds the sum of this received IP packet */
+#define PBUF_FLAG_RX_CHKSUM 0x04U
 
 struct pbuf {
   /** next pbuf in singly linked pbuf chain */
@@ -93,6 +97,12 @@ struct pbuf {
    */
   u16_t ref;
 
+#if LWIP_CHECKSUM_ON_RX
+  /** the one's complement sum, folded to 16 bits but not inverted, the
+   *  network driver took of a received IP packet (see PBUF_FLAG_RX_CHKSUM) */
+  u16_t rx_chksum;
+#endif /* LWIP_CHECKSUM_ON_RX */
+
 #if LWIP_PTPD
   /* the time at which the packet was received, seconds component */
   u32_t time_s;
@@ -106,6 +116,9 @@ struct pbuf {
 #define pbuf_init()
 
 struct pbuf *pbuf_alloc(pbuf_layer l, u16_t size, pbuf_type type);
+#if PBUF_POOL_LARGE_SIZE
+struct pbuf *pbuf_alloc_large(u16_t size);
+#endif /* PBUF_POOL_LARGE_SIZE */
 void pbuf_realloc(struct pbuf *p, u16_t size); 
 u8_t pbuf_header(struct pbuf *p, s16_t header_size);
 void pbuf_ref(struct pbuf *p);
@@ -101,12 +101,19 @@ struct etharp_entry {
   struct eth_addr ethaddr;
   enum etharp_state state;
   u8_t ctime;
+  /** index + 1 of the next entry in the same hash chain, 0 ends the chain */
+  u8_t next;
   struct netif *netif;
 };
 
 const struct eth_addr ethbroadcast = {{0xff,0xff,0xff,0xff,0xff,0xff}};
 const struct eth_addr ethzero = {{0,0,0,0,0,0}};
 static struct etharp_entry arp_table[ARP_TABLE_SIZE];
+/** index + 1 of the first entry of each hash chain, 0 for an empty chain.
+ *  An entry is on the chain of its IP address while it is pending or stable,
+ *  and arp_table_used counts the entries on the chains. */
+static u8_t arp_hash[ARP_HASH_SIZE];
+static u8_t arp_table_used;
 #if !LWIP_NETIF_HWADDRHINT
 static u8_t etharp_cached_entry;
 #endif
@@ -132,6 +139,56 @@ static err_t update_arp_entry(struct netif *netif, struct ip_addr *ipaddr, struc
 #if (LWIP_ARP && (ARP_TABLE_SIZE > 0x7f))
   #error "If you want to use ARP, ARP_TABLE_SIZE must fit in an s8_t, so, you have to reduce it in your lwipopts.h"
 #endif
+#if (LWIP_ARP && ((ARP_HASH_SIZE & (ARP_HASH_SIZE - 1)) != 0))
+  #error "ARP_HASH_SIZE must be a power of two, so, you have to change it in your lwipopts.h"
+#endif
+
+/**
+ * Hash an IP address to its chain in arp_hash. All four bytes are folded,
+ * so the result does not depend on byte order, and hosts on one subnet,
+ * which differ in the last byte only, land on different chains.
+ */
+static u8_t
+etharp_hash(struct ip_addr *ipaddr)
+{
+  u32_t h = ipaddr->addr;
+
+  h ^= h >> 16;
+  h ^= h >> 8;
+  return (u8_t)(h & (ARP_HASH_SIZE - 1));
+}
+
+/**
+ * Put ARP table entry i on the hash chain of its IP address.
+ */
+static void
+etharp_hash_add(u8_t i)
+{
+  u8_t *head = &arp_hash[etharp_hash(&arp_table[i].ipaddr)];
+
+  arp_table[i].next = *head;
+  *head = i + 1;
+  arp_table_used++;
+}
+
+/**
+ * Take ARP table entry i off the hash chain of its IP address.
+ */
+static void
+etharp_hash_remove(u8_t i)
+{
+  u8_t *link = &arp_hash[etharp_hash(&arp_table[i].ipaddr)];
+
+  while (*link != 0) {
+    if (*link == (u8_t)(i + 1)) {
+      *link = arp_table[i].next;
+      arp_table_used--;
+      return;
+    }
+    link = &arp_table[*link - 1].next;
+  }
+  LWIP_ASSERT("ARP entry is on its hash chain", 0);
+}
 
 
 #if ARP_QUEUEING
@@ -190,7 +247,8 @@ etharp_tmr(void)
         arp_table[i].q = NULL;
       }
 #endif
-      /* recycle entry for re-use */      
+      /* take it out of the hash index and recycle entry for re-use */
+      etharp_hash_remove(i);
       arp_table[i].state = ETHARP_STATE_EMPTY;
     }
 #if ARP_QUEUEING
@@ -211,6 +269,11 @@ etharp_tmr(void)
  * state of the returned entry.
  * 
  * If ipaddr is NULL, return a initialized new entry in state ETHARP_EMPTY.
+ * Such an entry is not in the hash index, so the caller must not make it
+ * pending or stable.
+ *
+ * Matching entries are looked up through the hash index; the table itself is
+ * only scanned when a new entry has to be created.
  * 
  * In all cases, attempt to create new entries from an empty entry. If no
  * empty entries are available and ETHARP_TRY_HARD flag is set, recycle
@@ -234,6 +297,7 @@ find_entry(struct ip_addr *ipaddr, u8_t flags)
   s8_t old_pending = ARP_TABLE_SIZE, old_stable = ARP_TABLE_SIZE;
   s8_t empty = ARP_TABLE_SIZE;
   u8_t i = 0, age_pending = 0, age_stable = 0;
+  u8_t j;
 #if ARP_QUEUEING
   /* oldest entry with packets on queue */
   s8_t old_queue = ARP_TABLE_SIZE;
@@ -268,6 +332,32 @@ find_entry(struct ip_addr *ipaddr, u8_t flags)
       }
     }
 #endif /* #if LWIP_NETIF_HWADDRHINT */
+
+    /* search the hash chain of the address for a pending or stable entry */
+    for (j = arp_hash[etharp_hash(ipaddr)]; j != 0; j = arp_table[j - 1].next) {
+      i = j - 1;
+      LWIP_ASSERT("hashed entry is in use", arp_table[i].state != ETHARP_STATE_EMPTY);
+      if (ip_addr_cmp(ipaddr, &arp_table[i].ipaddr)) {
+        LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("find_entry: found matching %s entry %"U16_F"\n",
+          arp_table[i].state == ETHARP_STATE_STABLE ? "stable" : "pending", (u16_t)i));
+        /* found exact IP address match, simply bail out */
+#if LWIP_NETIF_HWADDRHINT
+        NETIF_SET_HINT(netif, i);
+#else /* #if LWIP_NETIF_HWADDRHINT */
+        etharp_cached_entry = i;
+#endif /* #if LWIP_NETIF_HWADDRHINT */
+        return i;
+      }
+    }
+  }
+  /* { we have no match } => try to create a new entry */
+
+  /* don't create new entry, only search? or no empty entry left and not
+   * allowed to recycle? Bail out without scanning the table. */
+  if (((flags & ETHARP_FIND_ONLY) != 0) ||
+      ((arp_table_used >= ARP_TABLE_SIZE) && ((flags & ETHARP_TRY_HARD) == 0))) {
+    LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("find_entry: no empty entry found and not allowed to recycle\n"));
+    return (s8_t)ERR_MEM;
   }
 
   /**
@@ -281,8 +371,6 @@ find_entry(struct ip_addr *ipaddr, u8_t flags)
    * 2) remember the oldest stable entry (if any)
    * 3) remember the oldest pending entry without queued packets (if any)
    * 4) remember the oldest pending entry with queued packets (if any)
-   * 5) search for a matching IP entry, either pending or stable
-   *    until 5 matches, or all entries are searched for.
    */
 
   for (i = 0; i < ARP_TABLE_SIZE; ++i) {
@@ -294,26 +382,17 @@ find_entry(struct ip_addr *ipaddr, u8_t flags)
     }
     /* pending entry? */
     else if (arp_table[i].state == ETHARP_STATE_PENDING) {
-      /* if given, does IP address match IP address in ARP entry? */
-      if (ipaddr && ip_addr_cmp(ipaddr, &arp_table[i].ipaddr)) {
-        LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("find_entry: found matching pending entry %"U16_F"\n", (u16_t)i));
-        /* found exact IP address match, simply bail out */
-#if LWIP_NETIF_HWADDRHINT
-        NETIF_SET_HINT(netif, i);
-#else /* #if LWIP_NETIF_HWADDRHINT */
-        etharp_cached_entry = i;
-#endif /* #if LWIP_NETIF_HWADDRHINT */
-        return i;
 #if ARP_QUEUEING
       /* pending with queued packets? */
-      } else if (arp_table[i].q != NULL) {
+      if (arp_table[i].q != NULL) {
         if (arp_table[i].ctime >= age_queue) {
           old_queue = i;
           age_queue = arp_table[i].ctime;
         }
-#endif
       /* pending without queued packets? */
-      } else {
+      } else
+#endif
+      {
         if (arp_table[i].ctime >= age_pending) {
           old_pending = i;
           age_pending = arp_table[i].ctime;
@@ -322,29 +401,16 @@ find_entry(struct ip_addr *ipaddr, u8_t flags)
     }
     /* stable entry? */
     else if (arp_table[i].state == ETHARP_STATE_STABLE) {
-      /* if given, does IP address match IP address in ARP entry? */
-      if (ipaddr && ip_addr_cmp(ipaddr, &arp_table[i].ipaddr)) {
-        LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("find_entry: found matching stable entry %"U16_F"\n", (u16_t)i));
-        /* found exact IP address match, simply bail out */
-#if LWIP_NETIF_HWADDRHINT
-        NETIF_SET_HINT(netif, i);
-#else /* #if LWIP_NETIF_HWADDRHINT */
-        etharp_cached_entry = i;
-#endif /* #if LWIP_NETIF_HWADDRHINT */
-        return i;
       /* remember entry with oldest stable entry in oldest, its age in maxtime */
-      } else if (arp_table[i].ctime >= age_stable) {
+      if (arp_table[i].ctime >= age_stable) {
         old_stable = i;
         age_stable = arp_table[i].ctime;
       }
     }
   }
-  /* { we have no match } => try to create a new entry */
-   
+
   /* no empty entry found and not allowed to recycle? */
-  if (((empty == ARP_TABLE_SIZE) && ((flags & ETHARP_TRY_HARD) == 0))
-      /* or don't create new entry, only search? */
-      || ((flags & ETHARP_FIND_ONLY) != 0)) {
+  if ((empty == ARP_TABLE_SIZE) && ((flags & ETHARP_TRY_HARD) == 0)) {
     LWIP_DEBUGF(ETHARP_DEBUG | LWIP_DBG_TRACE, ("find_entry: no empty entry found and not allowed to recycle\n"));
     return (s8_t)ERR_MEM;
   }
@@ -397,14 +463,16 @@ find_entry(struct ip_addr *ipaddr, u8_t flags)
   if (arp_table[i].state != ETHARP_STATE_EMPTY)
   {
     snmp_delete_arpidx_tree(arp_table[i].netif, &arp_table[i].ipaddr);
+    etharp_hash_remove(i);
   }
   /* recycle entry (no-op for an already empty entry) */
   arp_table[i].state = ETHARP_STATE_EMPTY;
 
   /* IP address given? */
   if (ipaddr != NULL) {
-    /* set IP address */
+    /* set IP address and index the entry under it */
     ip_addr_set(&arp_table[i].ipaddr, ipaddr);
+    etharp_hash_add(i);
   }
   arp_table[i].ctime = 0;
 #if LWIP_NETIF_HWADDRHINT
@@ -679,7 +747,15 @@ etharp_arp_input(struct netif *netif, struct eth_addr *ethaddr, struct pbuf *p)
   if (for_us) {
     /* add IP address in ARP cache; assume requester wants to talk to us.
      * can result in directly sending the queued packets for this host. */
+#if ETHARP_RECYCLE_ON_INPUT
     update_arp_entry(netif, &sipaddr, &(hdr->shwaddr), ETHARP_TRY_HARD);
+#else /* ETHARP_RECYCLE_ON_INPUT */
+    /* only take a free entry; we still reply, and if the sender really
+     * talks to us the entry is created when we answer */
+    if (update_arp_entry(netif, &sipaddr, &(hdr->shwaddr), 0) == ERR_MEM) {
+      ETHARP_STATS_INC(etharp.memerr);
+    }
+#endif /* ETHARP_RECYCLE_ON_INPUT */
   /* ARP message not directed to us? */
   } else {
     /* update the source IP address in the cache, if present */
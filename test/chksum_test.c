@@ -0,0 +1,160 @@
+//*****************************************************************************
+//
+// chksum_test.c - Host check and benchmark of the lwIP checksum.
+//
+// Built once for each LWIP_CHKSUM_ALGORITHM against the unmodified
+// inet_chksum.c.  inet_chksum() is compared against a byte at a time
+// RFC 1071 sum for every length up to a full frame at every alignment, and
+// then timed on 1500 byte packets.  The times are those of the host, so only
+// the ratios between the algorithms mean anything for the target; there the
+// bench command of the console measures them in cycles.
+//
+//*****************************************************************************
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include "lwip/opt.h"
+#include "lwip/inet.h"
+#include "lwip/inet_chksum.h"
+
+//*****************************************************************************
+//
+// The longest packet checked, and the number of packets timed.
+//
+//*****************************************************************************
+#define MAX_LEN                 1600
+#define BENCH_LEN               1500
+#define BENCH_LOOPS             200000
+
+static unsigned char g_pucBuf[MAX_LEN + 8] __attribute__((aligned(8)));
+
+//*****************************************************************************
+//
+// The one's complement sum of the bytes at pucData, taken as big endian
+// 16-bit words, in network order like lwip_standard_chksum().
+//
+//*****************************************************************************
+static u16_t
+RefChksum(const unsigned char *pucData, int iLen)
+{
+    u32_t ulSum;
+
+    ulSum = 0;
+    while(iLen > 1)
+    {
+        ulSum += (pucData[0] << 8) | pucData[1];
+        pucData += 2;
+        iLen -= 2;
+    }
+    if(iLen)
+    {
+        ulSum += pucData[0] << 8;
+    }
+    while(ulSum >> 16)
+    {
+        ulSum = (ulSum >> 16) + (ulSum & 0xffff);
+    }
+
+    return(htons((u16_t)ulSum));
+}
+
+//*****************************************************************************
+//
+// Compare inet_chksum() with the reference for every length and alignment.
+// Returns the number of mismatches.
+//
+//*****************************************************************************
+static int
+Check(void)
+{
+    int iOff, iLen, iBad;
+    u16_t usGot, usWant;
+
+    iBad = 0;
+    for(iOff = 0; iOff < 8; iOff++)
+    {
+        for(iLen = 0; iLen <= MAX_LEN; iLen++)
+        {
+            usGot = inet_chksum(g_pucBuf + iOff, (u16_t)iLen);
+            usWant = (u16_t)~RefChksum(g_pucBuf + iOff, iLen);
+
+            //
+            // 0x0000 and 0xffff are the same one's complement number.
+            //
+            if((usGot != usWant) &&
+               !(((usGot == 0) || (usGot == 0xffff)) &&
+                 ((usWant == 0) || (usWant == 0xffff))))
+            {
+                if(iBad++ < 10)
+                {
+                    printf("offset %d length %d: %04x, expected %04x\n",
+                           iOff, iLen, usGot, usWant);
+                }
+            }
+        }
+    }
+
+    return(iBad);
+}
+
+//*****************************************************************************
+//
+// Time inet_chksum() on packets at an even and an odd address.
+//
+//*****************************************************************************
+static void
+Bench(void)
+{
+    volatile u16_t usSink;
+    clock_t lStart;
+    int iOff, i;
+
+    for(iOff = 0; iOff < 2; iOff++)
+    {
+        usSink = 0;
+        lStart = clock();
+        for(i = 0; i < BENCH_LOOPS; i++)
+        {
+            usSink += inet_chksum(g_pucBuf + iOff, BENCH_LEN);
+        }
+        printf("algorithm %d, %s address: %.1f ns per %d bytes\n",
+               LWIP_CHKSUM_ALGORITHM, iOff ? "odd" : "even",
+               ((double)(clock() - lStart) / CLOCKS_PER_SEC) * 1e9 /
+               BENCH_LOOPS, BENCH_LEN);
+    }
+}
+
+int
+main(void)
+{
+    int iBad, i;
+
+    srand(1);
+    for(i = 0; i < sizeof(g_pucBuf); i++)
+    {
+        g_pucBuf[i] = rand();
+    }
+    iBad = Check();
+
+    //
+    // All ones makes every add carry.
+    //
+    memset(g_pucBuf, 0xff, sizeof(g_pucBuf));
+    iBad += Check();
+
+    printf("algorithm %d: %d mismatches\n", LWIP_CHKSUM_ALGORITHM, iBad);
+    if(iBad)
+    {
+        return(1);
+    }
+
+    for(i = 0; i < sizeof(g_pucBuf); i++)
+    {
+        g_pucBuf[i] = rand();
+    }
+    Bench();
+
+    return(0);
+}
@@ -0,0 +1,15 @@
+//*****************************************************************************
+//
+// lwipopts.h - The firmware's lwIP options, for the host tests.
+//
+// TEST_CHKSUM_ALGORITHM selects another checksum algorithm than the one the
+// firmware uses, so that each one can be checked and timed.
+//
+//*****************************************************************************
+
+#include "../../app/lwipopts.h"
+
+#ifdef TEST_CHKSUM_ALGORITHM
+#undef LWIP_CHKSUM_ALGORITHM
+#define LWIP_CHKSUM_ALGORITHM   TEST_CHKSUM_ALGORITHM
+#endif
@@ -0,0 +1,251 @@
+//*****************************************************************************
+//
+// rx_chksum_test.c - Host test of the receive path of the Ethernet driver.
+//
+// The driver is built from stellarisif.c with the firmware's lwipopts.h, and
+// the rx fifo is simulated by pointing HWREG() at a frame buffer.  Frames of
+// every IP length are received into a large pbuf and, with the large pool
+// held, into chains of pool pbufs.  The test checks that the copy matches the
+// frame, that the fifo is read to the end of the frame, and that the sum left
+// for inet_chksum_pseudo_rx() is that of the IP packet alone, not of the
+// Ethernet padding or the FCS after it.
+//
+//*****************************************************************************
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "hw_types.h"
+
+//*****************************************************************************
+//
+// Read the rx fifo from g_pulFifo; every other register reads as 0 and
+// ignores writes.
+//
+//*****************************************************************************
+#undef HWREG
+#define HWREG(x)                (*HostReg(x))
+static uint32_t *HostReg(unsigned long ulAddr);
+
+//*****************************************************************************
+//
+// The driver is written for a 32-bit target and keeps fifo words in unsigned
+// longs, so build it with long as wide as the target's.
+//
+//*****************************************************************************
+#define long                    int
+#include "../lwip-1.3.0/ports/stellaris/netif/stellarisif.c"
+#undef long
+
+//*****************************************************************************
+//
+// The test is single threaded, so lwIP needs no protection.
+//
+//*****************************************************************************
+sys_prot_t
+sys_arch_protect(void)
+{
+    return(0);
+}
+
+void
+sys_arch_unprotect(sys_prot_t pval)
+{
+}
+
+#define FIFO_WORDS              ((1600 + 8) / 4)
+
+static uint32_t g_pulFifo[FIFO_WORDS];
+static unsigned long g_ulFifoRead;
+
+static uint32_t *
+HostReg(unsigned long ulAddr)
+{
+    static uint32_t ulOther;
+
+    if(ulAddr == (ETH_BASE + MAC_O_DATA))
+    {
+        return(&g_pulFifo[g_ulFifoRead++ % FIFO_WORDS]);
+    }
+    ulOther = 0;
+    return(&ulOther);
+}
+
+//*****************************************************************************
+//
+// The folded one's complement sum of the bytes at pucData, in the byte order
+// of the words read from the fifo.
+//
+//*****************************************************************************
+static u16_t
+RefSum(const unsigned char *pucData, int iLen)
+{
+    u32_t ulSum;
+
+    ulSum = 0;
+    while(iLen > 1)
+    {
+        ulSum += pucData[0] | (pucData[1] << 8);
+        pucData += 2;
+        iLen -= 2;
+    }
+    if(iLen)
+    {
+        ulSum += pucData[0];
+    }
+    while(ulSum >> 16)
+    {
+        ulSum = (ulSum >> 16) + (ulSum & 0xffff);
+    }
+
+    return((u16_t)ulSum);
+}
+
+//*****************************************************************************
+//
+// Put a UDP packet to the SNMP port, iIPLen bytes long and followed by
+// iTrailer bytes of padding, in the fifo and receive it.  Returns the number
+// of failed checks.
+//
+//*****************************************************************************
+static int
+Receive(struct netif *psNetif, int iIPLen, int iTrailer)
+{
+    unsigned char pucFrame[FIFO_WORDS * 4];
+    struct pbuf *p, *q;
+    int iFrameLen, iLen, iOff, iBad, i;
+    u16_t usGot, usWant;
+
+    //
+    // The fifo holds the 2 byte length, the frame, padded to the Ethernet
+    // minimum, and the FCS; the length counts all of them.
+    //
+    iFrameLen = 14 + iIPLen;
+    if(iFrameLen < 60)
+    {
+        iFrameLen = 60;
+    }
+    iFrameLen += iTrailer;
+    iLen = 2 + iFrameLen + 4;
+
+    for(i = 0; i < sizeof(pucFrame); i++)
+    {
+        pucFrame[i] = rand();
+    }
+    pucFrame[0] = iLen & 0xff;
+    pucFrame[1] = iLen >> 8;
+    pucFrame[2 + 12] = 0x08;
+    pucFrame[2 + 13] = 0x00;
+    pucFrame[16 + 0] = 0x45;
+    pucFrame[16 + 2] = iIPLen >> 8;
+    pucFrame[16 + 3] = iIPLen & 0xff;
+    pucFrame[16 + 6] = 0;
+    pucFrame[16 + 7] = 0;
+    pucFrame[16 + 9] = IP_PROTO_UDP;
+    pucFrame[16 + 22] = 0;
+    pucFrame[16 + 23] = 161;
+    memcpy(g_pulFifo, pucFrame, sizeof(pucFrame));
+    g_ulFifoRead = 0;
+
+    iBad = 0;
+    p = low_level_receive(psNetif);
+    if(g_ulFifoRead != ((iLen + 3) / 4))
+    {
+        printf("ip length %d: read %lu fifo words, expected %d\n", iIPLen,
+               g_ulFifoRead, (iLen + 3) / 4);
+        iBad++;
+    }
+    if(p == NULL)
+    {
+        printf("ip length %d: not received\n", iIPLen);
+        return(iBad + 1);
+    }
+
+    iOff = 0;
+    for(q = p; q != NULL; q = q->next)
+    {
+        if(memcmp(q->payload, pucFrame + iOff, q->len))
+        {
+            printf("ip length %d: copy differs at %d\n", iIPLen, iOff);
+            iBad++;
+            break;
+        }
+        iOff += q->len;
+    }
+
+    if(!(p->flags & PBUF_FLAG_RX_CHKSUM))
+    {
+        printf("ip length %d: no sum\n", iIPLen);
+        iBad++;
+    }
+    else
+    {
+        //
+        // 0x0000 and 0xffff are the same one's complement number.
+        //
+        usGot = (p->rx_chksum == 0xffff) ? 0 : p->rx_chksum;
+        usWant = RefSum(pucFrame + 16, iIPLen);
+        usWant = (usWant == 0xffff) ? 0 : usWant;
+        if(usGot != usWant)
+        {
+            printf("ip length %d, %s: sum %04x, expected %04x\n", iIPLen,
+                   p->next ? "chained" : "one pbuf", usGot, usWant);
+            iBad++;
+        }
+    }
+
+    pbuf_free(p);
+    return(iBad);
+}
+
+int
+main(void)
+{
+    struct pbuf *ppsLarge[PBUF_POOL_LARGE_SIZE + 1];
+    struct netif sNetif;
+    int iHeld, iChained, iIPLen, iTrailer, iCases, iBad;
+
+    mem_init();
+    memp_init();
+    memset(&sNetif, 0, sizeof(sNetif));
+    sNetif.state = &ethernetif_data;
+    srand(7);
+
+    iCases = 0;
+    iBad = 0;
+    for(iChained = 0; iChained < 2; iChained++)
+    {
+        //
+        // Take the large pbufs the second time, so that the frames that do
+        // not fit one pool pbuf are received into a chain.
+        //
+        iHeld = 0;
+        if(iChained)
+        {
+            while((iHeld <= PBUF_POOL_LARGE_SIZE) &&
+                  ((ppsLarge[iHeld] = pbuf_alloc_large(1500)) != NULL))
+            {
+                iHeld++;
+            }
+        }
+
+        for(iIPLen = IP_HLEN; iIPLen <= 1500;
+            iIPLen += (iIPLen < 80) ? 1 : 37)
+        {
+            for(iTrailer = 0; iTrailer < 6; iTrailer += 2)
+            {
+                iBad += Receive(&sNetif, iIPLen, iTrailer);
+                iCases++;
+            }
+        }
+
+        while(iHeld)
+        {
+            pbuf_free(ppsLarge[--iHeld]);
+        }
+    }
+
+    printf("%d frames, %d failed checks\n", iCases, iBad);
+    return(iBad != 0);
+}